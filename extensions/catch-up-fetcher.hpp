@@ -0,0 +1,276 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#ifndef CATCH_UP_FETCHER_HPP_
+#define CATCH_UP_FETCHER_HPP_
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <set>
+
+#include "node.hpp"
+
+namespace ndn {
+namespace vsync {
+namespace app {
+
+// Prefetches the data a node is missing once it finds itself far behind a
+// publisher, e.g. after losses or missed heartbeats.
+//
+// When the version vector shows a member at least |threshold| items ahead of
+// what has been delivered, the missing range is requested with a window of
+// interests that grows by one per window of Data and halves on a timeout or
+// Nack (AIMD), up to |max_window|. The prefetched Data lands in the local
+// content store, so the sync node's own fetches for the range are answered
+// locally instead of costing a round trip each. A catch-up ends when every
+// item in its range has been delivered to the application.
+//
+// The library keeps its data naming to itself. Names are therefore taken
+// from the member's own data: every name of a member in a view is the same
+// up to its sequence number, so the names of the missing items are those of
+// the last item delivered from the member with the sequence number swapped.
+// Sequence numbers start over in every view, so all state is dropped on a
+// view change.
+class CatchUpFetcher {
+ public:
+  // Parameters are the member, the depth of the catch-up (items behind when
+  // it started) and the time from its start until the range was delivered.
+  using DoneCb =
+      std::function<void(const Name&, uint64_t, time::nanoseconds)>;
+
+  CatchUpFetcher(Face& face, Scheduler& scheduler, const Name& nid,
+                 uint64_t threshold, std::size_t max_window, DoneCb done)
+      : face_(face),
+        scheduler_(scheduler),
+        nid_(nid),
+        threshold_(std::max<uint64_t>(threshold, 1)),
+        max_window_(std::max<std::size_t>(max_window, 1)),
+        done_(done) {}
+
+  void SetViewInfo(const ViewInfo& vinfo) {
+    vinfo_ = vinfo;
+    ids_.clear();
+    for (std::size_t i = 0; i < vinfo.Size(); ++i)
+      ids_.insert(vinfo.GetIDByIndex(i).first);
+    streams_.clear();
+    current_.clear();
+    ++epoch_;
+  }
+
+  // Learns where the sequence number sits in data names from the node's own
+  // data: |seq| is the number of items the node has published, including
+  // |name|.
+  void OnLocalData(const Name& name, uint64_t seq) {
+    if (seq_offset_ > 0 || !nid_.isPrefixOf(name)) return;
+    for (std::size_t i = nid_.size(); i < name.size(); ++i)
+      if (name.get(i).isNumber() && name.get(i).toNumber() == seq)
+        seq_offset_ = name.size() - i;
+  }
+
+  // Records that the sync node delivered |name| to the application.
+  void OnData(const Name& name) {
+    Name member;
+    if (!FindMember(name, member)) return;
+    if (seq_offset_ == 0) LearnSeqOffset(member, name);
+    if (seq_offset_ == 0 || name.size() < member.size() + seq_offset_) return;
+
+    Name stream = StreamOf(name);
+    uint64_t seq = name.get(-seq_offset_).toNumber();
+    auto it = streams_.find(stream);
+    if (it == streams_.end()) {
+      it = streams_.emplace(stream, Member()).first;
+      it->second.id = member;
+      current_[member] = stream;
+    }
+
+    auto& m = it->second;
+    if (seq <= m.delivered) return;
+    m.pending.insert(seq);
+    while (!m.pending.empty() && *m.pending.begin() == m.delivered + 1) {
+      m.pending.erase(m.pending.begin());
+      ++m.delivered;
+    }
+    if (m.active && m.delivered >= m.target) {
+      m.active = false;
+      done_(member, m.depth, time::steady_clock::now() - m.start);
+    }
+  }
+
+  void OnVectorChange(std::size_t idx, const VersionVector& vv) {
+    if (idx >= vv.size()) return;
+    auto id = vinfo_.GetIDByIndex(idx);
+    if (!id.second || id.first == nid_) return;
+    // Without an item of the member in this view there is no name to start
+    // from; the sync node fetches the first one.
+    auto current = current_.find(id.first);
+    if (current == current_.end()) return;
+    const Name& stream = current->second;
+
+    auto& m = streams_[stream];
+    uint64_t known = vv[idx];
+    if (m.active) {
+      m.target = std::max(m.target, known);
+      Fill(stream, m);
+      return;
+    }
+    if (known < m.delivered + threshold_) return;
+    m.active = true;
+    m.target = known;
+    m.depth = known - m.delivered;
+    m.next = m.delivered + 1;
+    m.start = time::steady_clock::now();
+    Fill(stream, m);
+  }
+
+ private:
+  // Catch-up state of one member in one view.
+  struct Member {
+    Name id;
+    uint64_t delivered = 0;
+    std::set<uint64_t> pending;
+
+    bool active = false;
+    uint64_t target = 0;
+    uint64_t depth = 0;
+    time::steady_clock::TimePoint start;
+    uint64_t next = 1;
+    double window = 2.0;
+    std::size_t in_flight = 0;
+    std::map<uint64_t, int> retries;
+  };
+
+  static const int kMaxRetries = 3;
+
+  // Longest member ID of the view that is a prefix of |name|.
+  bool FindMember(const Name& name, Name& member) const {
+    for (std::size_t n = name.size(); n > 0; --n) {
+      if (ids_.count(name.getPrefix(n)) > 0) {
+        member = name.getPrefix(n);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Until the node has published, the sequence number is the one numeric
+  // component in which two items of a member differ.
+  void LearnSeqOffset(const Name& member, const Name& name) {
+    Name& last = last_names_[member];
+    if (last.size() == name.size()) {
+      std::size_t diffs = 0, pos = 0;
+      for (std::size_t i = member.size(); i < name.size(); ++i) {
+        if (name.get(i) != last.get(i)) {
+          ++diffs;
+          pos = i;
+        }
+      }
+      if (diffs == 1 && name.get(pos).isNumber() && last.get(pos).isNumber())
+        seq_offset_ = name.size() - pos;
+    }
+    last = name;
+    if (seq_offset_ > 0) last_names_.clear();
+  }
+
+  // |name| without its sequence number, which identifies the member and the
+  // view.
+  Name StreamOf(const Name& name) const {
+    return name.getPrefix(name.size() - seq_offset_)
+        .append(name.getSubName(name.size() - seq_offset_ + 1));
+  }
+
+  Name MakeName(const Name& stream, uint64_t seq) const {
+    std::size_t pos = stream.size() - (seq_offset_ - 1);
+    return stream.getPrefix(pos).appendNumber(seq).append(
+        stream.getSubName(pos));
+  }
+
+  void Fill(const Name& stream, Member& m) {
+    m.next = std::max(m.next, m.delivered + 1);
+    while (m.in_flight < static_cast<std::size_t>(m.window) &&
+           m.next <= m.target)
+      Express(stream, m, m.next++);
+  }
+
+  void Express(const Name& stream, Member& m, uint64_t seq) {
+    ++m.in_flight;
+    uint64_t epoch = epoch_;
+    face_.expressInterest(
+        Interest(MakeName(stream, seq)),
+        [this, stream, epoch](const Interest&, const Data&) {
+          if (epoch == epoch_) OnFetched(stream);
+        },
+        [this, stream, seq, epoch](const Interest&, const lp::Nack&) {
+          if (epoch == epoch_) OnLost(stream, seq, true);
+        },
+        [this, stream, seq, epoch](const Interest&) {
+          if (epoch == epoch_) OnLost(stream, seq, false);
+        });
+  }
+
+  void OnFetched(const Name& stream) {
+    auto& m = streams_[stream];
+    --m.in_flight;
+    m.window = std::min<double>(m.window + 1.0 / m.window, max_window_);
+    if (m.active) Fill(stream, m);
+  }
+
+  // A Nack comes back at once, so its retry waits kNackBackoff, doubled for
+  // every retry of the item; a timed out interest has waited its lifetime
+  // already.
+  void OnLost(const Name& stream, uint64_t seq, bool nacked) {
+    auto& m = streams_[stream];
+    --m.in_flight;
+    m.window = std::max(m.window / 2.0, 1.0);
+    if (!m.active || seq <= m.delivered) return;
+    int retries = ++m.retries[seq];
+    if (retries > kMaxRetries) {
+      // Leave the rest of the range to the sync node.
+      m.active = false;
+      m.retries.clear();
+      return;
+    }
+    if (!nacked) {
+      Express(stream, m, seq);
+      return;
+    }
+    ++m.in_flight;
+    uint64_t epoch = epoch_;
+    scheduler_.scheduleEvent(kNackBackoff * (1 << (retries - 1)),
+                             [this, stream, seq, epoch] {
+                               if (epoch != epoch_) return;
+                               auto& m = streams_[stream];
+                               --m.in_flight;
+                               if (m.active && seq > m.delivered)
+                                 Express(stream, m, seq);
+                             });
+  }
+
+  Face& face_;
+  Scheduler& scheduler_;
+  const Name nid_;
+  const uint64_t threshold_;
+  const std::size_t max_window_;
+  DoneCb done_;
+  const time::milliseconds kNackBackoff = time::milliseconds(50);
+
+  ViewInfo vinfo_;
+  std::set<Name> ids_;
+  // Position of the sequence number in data names, from the end; zero until
+  // learned.
+  std::size_t seq_offset_ = 0;
+  // Last item delivered from each member while |seq_offset_| is unknown.
+  std::map<Name, Name> last_names_;
+  // Catch-up state by data name without the sequence number, i.e. by member
+  // and view.
+  std::map<Name, Member> streams_;
+  // Stream of each member in the current view.
+  std::map<Name, Name> current_;
+  // Incremented on every view change, to drop replies to earlier interests.
+  uint64_t epoch_ = 0;
+};
+
+}  // namespace app
+}  // namespace vsync
+}  // namespace ndn
+
+#endif  // CATCH_UP_FETCHER_HPP_
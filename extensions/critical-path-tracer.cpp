@@ -0,0 +1,237 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#include "critical-path-tracer.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "ns3/callback.h"
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+
+#include "ns3/ndnSIM/model/ndn-l3-protocol.hpp"
+
+#include "vsync-names.hpp"
+
+NS_LOG_COMPONENT_DEFINE("ns3.ndn.vsync.CriticalPathTracer");
+
+namespace ns3 {
+namespace ndn {
+namespace vsync {
+
+static std::string Span(double from, double to) {
+  if (from < 0.0 || to < 0.0) return "n/a";
+  std::ostringstream os;
+  os << to - from << " seconds";
+  return os.str();
+}
+
+CriticalPathTracer::CriticalPathTracer(double sampling_rate, double threshold)
+    : sampling_rate_(sampling_rate), threshold_(threshold) {
+  sampler_ = CreateObject<UniformRandomVariable>();
+  sampler_->SetAttribute("Min", DoubleValue(0.0));
+  sampler_->SetAttribute("Max", DoubleValue(1.0));
+}
+
+void CriticalPathTracer::Connect(Ptr<Application> app,
+                                 const std::string& nid) {
+  members_[nid];
+  app->TraceConnect("DataEvent", nid,
+                    MakeCallback(&CriticalPathTracer::DataEvent, this));
+  app->TraceConnect("ViewChange", nid,
+                    MakeCallback(&CriticalPathTracer::ViewChange, this));
+
+  Ptr<L3Protocol> l3 = app->GetNode()->GetObject<L3Protocol>();
+  l3->TraceConnect("InInterests", nid,
+                   MakeCallback(&CriticalPathTracer::InInterests, this));
+  l3->TraceConnect("InData", nid,
+                   MakeCallback(&CriticalPathTracer::InData, this));
+}
+
+void CriticalPathTracer::DataEvent(std::string nid,
+                                   std::shared_ptr<const Data> data,
+                                   bool is_local) {
+  double now = Simulator::Now().GetSeconds();
+  auto name = data->getName().toUri();
+  auto& member = members_[nid];
+
+  if (!is_local) {
+    auto iter = items_.find(name);
+    if (iter != items_.end()) iter->second.hops[nid].delivered = now;
+    return;
+  }
+
+  ++member.published;
+  if (sampler_->GetValue() >= sampling_rate_) return;
+
+  auto& item = items_[name];
+  item.publisher = nid;
+  item.seq = member.published;
+  item.published = now;
+  member.unannounced.push_back(name);
+  for (auto& m : members_)
+    if (m.first != nid) m.second.unnotified.push_back(name);
+}
+
+void CriticalPathTracer::ViewChange(std::string nid,
+                                    const ::ndn::vsync::ViewID& vid,
+                                    const ::ndn::vsync::ViewInfo& vinfo,
+                                    bool is_leader) {
+  auto& member = members_[nid];
+  member.vinfo = vinfo;
+  member.has_view = true;
+}
+
+void CriticalPathTracer::InInterests(std::string nid,
+                                     const Interest& interest,
+                                     const nfd::Face& face) {
+  double now = Simulator::Now().GetSeconds();
+  const auto& name = interest.getName();
+  bool from_app = face.getScope() == ::ndn::nfd::FACE_SCOPE_LOCAL;
+  auto& member = members_[nid];
+
+  if (::ndn::vsync::kSyncPrefix.isPrefixOf(name)) {
+    if (!from_app) {
+      OnSyncInterest(nid, member, name);
+      return;
+    }
+    for (const auto& s : member.unannounced) {
+      auto& item = items_[s];
+      item.notify_sent = now;
+      item.notify_name = name;
+    }
+    member.unannounced.clear();
+    return;
+  }
+
+  if (!from_app) return;
+  auto iter = items_.find(name.toUri());
+  if (iter == items_.end()) return;
+  auto& hop = iter->second.hops[nid];
+  if (hop.fetches++ == 0) hop.first_fetch = now;
+  hop.last_fetch = now;
+}
+
+void CriticalPathTracer::InData(std::string nid, const Data& data,
+                                const nfd::Face& face) {
+  if (face.getScope() == ::ndn::nfd::FACE_SCOPE_LOCAL) return;
+  auto iter = items_.find(data.getName().toUri());
+  if (iter == items_.end()) return;
+  auto& hop = iter->second.hops[nid];
+  if (hop.data_in < 0.0) hop.data_in = Simulator::Now().GetSeconds();
+}
+
+void CriticalPathTracer::OnSyncInterest(const std::string& nid,
+                                        Member& member, const Name& name) {
+  Name view_prefix;
+  ::ndn::vsync::VersionVector vv;
+  if (!::ndn::vsync::app::ParseSyncInterestName(name, view_prefix, vv)) return;
+
+  double now = Simulator::Now().GetSeconds();
+  const auto& vinfo = member.has_view ? member.vinfo : vinfo_;
+  auto& pending = member.unnotified;
+  pending.erase(
+      std::remove_if(pending.begin(), pending.end(),
+                     [&](const std::string& s) {
+                       auto& item = items_[s];
+                       auto idx = vinfo.GetIndexByID(Name(item.publisher));
+                       if (!idx.second || idx.first >= vv.size() ||
+                           vv[idx.first] < item.seq)
+                         return false;
+                       auto& hop = item.hops[nid];
+                       hop.notified = now;
+                       hop.direct = name == item.notify_name;
+                       return true;
+                     }),
+      pending.end());
+}
+
+void CriticalPathTracer::Report(const std::string& file) {
+  std::fstream fs(file, std::ios_base::out | std::ios_base::trunc);
+  fs << "Name\tReceiver\tPublished\tNotifySent\tNotified\tDirect\t"
+        "FirstFetch\tLastFetch\tFetches\tDataIn\tDelivered"
+     << std::endl;
+
+  std::vector<std::string> names;
+  for (const auto& item : items_) names.push_back(item.first);
+  std::sort(names.begin(), names.end());
+
+  int slow = 0;
+  int sync_bound = 0;
+  int fetch_bound = 0;
+  for (const auto& name : names) {
+    const auto& item = items_[name];
+    const std::string* slowest = nullptr;
+    const Hop* slowest_hop = nullptr;
+    for (const auto& h : item.hops) {
+      const auto& hop = h.second;
+      fs << name << '\t' << h.first << '\t' << item.published << '\t'
+         << item.notify_sent << '\t' << hop.notified << '\t'
+         << (hop.direct ? 'Y' : 'N') << '\t' << hop.first_fetch << '\t'
+         << hop.last_fetch << '\t' << hop.fetches << '\t' << hop.data_in
+         << '\t' << hop.delivered << std::endl;
+      if (hop.delivered < 0.0) continue;
+      if (slowest_hop == nullptr || hop.delivered > slowest_hop->delivered) {
+        slowest = &h.first;
+        slowest_hop = &hop;
+      }
+    }
+
+    if (slowest_hop == nullptr ||
+        slowest_hop->delivered - item.published <= threshold_)
+      continue;
+
+    ++slow;
+    double notified = slowest_hop->notified >= 0.0 ? slowest_hop->notified
+                                                   : slowest_hop->first_fetch;
+    if (notified < 0.0 ||
+        notified - item.published > slowest_hop->delivered - notified)
+      ++sync_bound;
+    else
+      ++fetch_bound;
+    PrintBreakdown(name, item, *slowest, *slowest_hop);
+  }
+
+  std::cout << "Number of traced data items is: " << items_.size()
+            << std::endl;
+  std::cout << "Number of traced data items above " << threshold_
+            << " seconds is: " << slow << std::endl;
+  std::cout << "Slow items dominated by sync notification: " << sync_bound
+            << ", by data fetching: " << fetch_bound << std::endl;
+}
+
+void CriticalPathTracer::PrintBreakdown(const std::string& name,
+                                        const Item& item,
+                                        const std::string& receiver,
+                                        const Hop& hop) {
+  double sent = item.notify_sent >= 0.0 ? item.notify_sent : item.published;
+
+  std::cout << "Critical path of " << name << " (published by "
+            << item.publisher << ", slowest receiver " << receiver << ", "
+            << Span(item.published, hop.delivered) << "):" << std::endl;
+  std::cout << "  publish -> sync interest sent: "
+            << Span(item.published, item.notify_sent) << std::endl;
+  std::cout << "  sync interest sent -> receiver notified: "
+            << Span(sent, hop.notified) << " ("
+            << (hop.notified < 0.0
+                    ? "not observed"
+                    : hop.direct ? "publisher's notification"
+                                 : "later sync interest, notification lost")
+            << ")" << std::endl;
+  std::cout << "  notified -> first fetch: "
+            << Span(hop.notified, hop.first_fetch) << std::endl;
+  std::cout << "  first fetch -> data received: "
+            << Span(hop.first_fetch, hop.data_in) << " (" << hop.fetches
+            << " fetch interests, " << Span(hop.first_fetch, hop.last_fetch)
+            << " in retransmissions)" << std::endl;
+  std::cout << "  data received -> delivered: "
+            << Span(hop.data_in, hop.delivered) << std::endl;
+}
+
+}  // namespace vsync
+}  // namespace ndn
+}  // namespace ns3
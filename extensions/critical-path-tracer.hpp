@@ -0,0 +1,114 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#ifndef CRITICAL_PATH_TRACER_HPP_
+#define CRITICAL_PATH_TRACER_HPP_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ns3/application.h"
+#include "ns3/ndnSIM/NFD/daemon/face/face.hpp"
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+#include "ns3/random-variable-stream.h"
+
+#include "node.hpp"
+
+namespace ns3 {
+namespace ndn {
+namespace vsync {
+
+// Follows a sampled subset of data items from publication to delivery at
+// every other member, so that a slow item can be explained rather than just
+// observed in the sync delay files.
+//
+// For each sampled item and receiver the tracer records when the publisher
+// sent its first sync interest after publishing, when the receiver first
+// heard a sync interest whose version vector covers the item (and whether
+// that was the publisher's notification or a later one, e.g. a heartbeat or
+// a retransmission), when the receiver's app sent the first and last fetch
+// interest for the item, when the data came back and when the app delivered
+// it. Events are taken from the members' L3 trace sources, so only members
+// connected through Connect() are observed.
+class CriticalPathTracer {
+ public:
+  // |sampling_rate| is the fraction of published items that are traced.
+  // Items whose slowest receiver took longer than |threshold| seconds get a
+  // critical-path breakdown on stdout.
+  CriticalPathTracer(double sampling_rate, double threshold);
+
+  // Sets the view used to locate publishers in version vectors until a
+  // member reports its own view through the ViewChange trace.
+  void SetViewInfo(const ::ndn::vsync::ViewInfo& vinfo) { vinfo_ = vinfo; }
+
+  void Connect(Ptr<Application> app, const std::string& nid);
+
+  // Writes one line per sampled item and receiver to |file| and prints the
+  // breakdown of items above the threshold.
+  void Report(const std::string& file);
+
+ private:
+  struct Hop {
+    double notified = -1.0;
+    bool direct = false;
+    double first_fetch = -1.0;
+    double last_fetch = -1.0;
+    int fetches = 0;
+    double data_in = -1.0;
+    double delivered = -1.0;
+  };
+
+  struct Item {
+    std::string publisher;
+    uint64_t seq = 0;
+    double published = 0.0;
+    double notify_sent = -1.0;
+    Name notify_name;
+    std::map<std::string, Hop> hops;
+  };
+
+  struct Member {
+    ::ndn::vsync::ViewInfo vinfo;
+    bool has_view = false;
+    uint64_t published = 0;
+    // Sampled items this member published and has not announced yet.
+    std::vector<std::string> unannounced;
+    // Sampled items of other members this member has not heard of yet.
+    std::vector<std::string> unnotified;
+  };
+
+  void DataEvent(std::string nid, std::shared_ptr<const Data> data,
+                 bool is_local);
+
+  void ViewChange(std::string nid, const ::ndn::vsync::ViewID& vid,
+                  const ::ndn::vsync::ViewInfo& vinfo, bool is_leader);
+
+  void InInterests(std::string nid, const Interest& interest,
+                   const nfd::Face& face);
+
+  void InData(std::string nid, const Data& data, const nfd::Face& face);
+
+  void OnSyncInterest(const std::string& nid, Member& member,
+                      const Name& name);
+
+  void PrintBreakdown(const std::string& name, const Item& item,
+                      const std::string& receiver, const Hop& hop);
+
+ private:
+  double sampling_rate_;
+  double threshold_;
+  Ptr<UniformRandomVariable> sampler_;
+  ::ndn::vsync::ViewInfo vinfo_;
+
+  std::unordered_map<std::string, Member> members_;
+  std::unordered_map<std::string, Item> items_;
+};
+
+}  // namespace vsync
+}  // namespace ndn
+}  // namespace ns3
+
+#endif  // CRITICAL_PATH_TRACER_HPP_
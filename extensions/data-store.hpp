@@ -0,0 +1,175 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#ifndef DATA_STORE_HPP_
+#define DATA_STORE_HPP_
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "node.hpp"
+
+namespace ndn {
+namespace vsync {
+namespace app {
+
+// What a DataStore may hold, and what it drops first once it holds more.
+struct RetentionPolicy {
+  enum Limit { kUnbounded, kCount, kBytes, kAge };
+  // kLru drops the item least recently inserted or looked up; kWindow keeps
+  // a window of the latest items of every publisher, dropping the oldest
+  // item of the publisher that holds the most. Items past a kAge limit are
+  // dropped oldest first either way.
+  enum Eviction { kLru, kWindow };
+
+  Limit limit = kUnbounded;
+  // Items, bytes or milliseconds, depending on |limit|.
+  uint64_t max = 0;
+  Eviction eviction = kLru;
+
+  // Parses "none", "count", "bytes" or "age", and "lru" or "window".
+  static RetentionPolicy Parse(const std::string& limit, uint64_t max,
+                               const std::string& eviction) {
+    RetentionPolicy policy;
+    if (limit == "count")
+      policy.limit = kCount;
+    else if (limit == "bytes")
+      policy.limit = kBytes;
+    else if (limit == "age")
+      policy.limit = kAge;
+    else if (limit != "none")
+      throw std::invalid_argument("Unknown retention limit: " + limit);
+    if (eviction == "window")
+      policy.eviction = kWindow;
+    else if (eviction != "lru")
+      throw std::invalid_argument("Unknown eviction order: " + eviction);
+    if (policy.limit != kUnbounded && max == 0)
+      throw std::invalid_argument("Retention limit " + limit +
+                                  " needs a maximum above 0");
+    policy.max = max;
+    return policy;
+  }
+};
+
+// An account of the Data a node would keep under a RetentionPolicy, with its
+// item count and wire size. The sync node keeps its own copy of every item,
+// which cannot be bounded from the application, so what this measures is
+// the memory a bounded store would take, not the memory the process holds.
+// Publishers are identified by the first |id_size| name components, the
+// length of a node ID.
+class DataStore {
+ public:
+  explicit DataStore(const RetentionPolicy& policy = RetentionPolicy(),
+                     std::size_t id_size = 1)
+      : policy_(policy), id_size_(id_size) {}
+
+  // The index points into itself.
+  DataStore(const DataStore&) = delete;
+  DataStore& operator=(const DataStore&) = delete;
+
+  void Insert(std::shared_ptr<const Data> data) {
+    const Name& name = data->getName();
+    if (index_.count(name) > 0) return;
+    uint64_t arrival = ++arrivals_count_;
+    lru_.push_front({data, data->wireEncode().size(),
+                     time::steady_clock::now(), arrival});
+    auto it = index_.emplace(name, lru_.begin()).first;
+    arrivals_.emplace(arrival, &it->first);
+    by_publisher_[name.getPrefix(id_size_)].emplace(arrival, &it->first);
+    bytes_ += lru_.front().size;
+    Evict();
+  }
+
+  // Returns nullptr if |name| is not, or no longer, held.
+  std::shared_ptr<const Data> Find(const Name& name) {
+    Evict();
+    auto it = index_.find(name);
+    if (it == index_.end()) return nullptr;
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return it->second->data;
+  }
+
+  std::size_t Size() const { return index_.size(); }
+
+  std::size_t Bytes() const { return bytes_; }
+
+  // Calls |f| on the items held, in the order they were inserted.
+  template <typename F>
+  void ForEach(F f) const {
+    for (const auto& arrival : arrivals_)
+      f(index_.find(*arrival.second)->second->data);
+  }
+
+ private:
+  struct Entry {
+    std::shared_ptr<const Data> data;
+    std::size_t size;
+    time::steady_clock::TimePoint inserted;
+    uint64_t arrival;
+  };
+
+  // Names held, by arrival number; they point into |index_|.
+  using Arrivals = std::map<uint64_t, const Name*>;
+
+  bool OverLimit() const {
+    switch (policy_.limit) {
+      case RetentionPolicy::kCount:
+        return index_.size() > policy_.max;
+      case RetentionPolicy::kBytes:
+        return bytes_ > policy_.max;
+      default:
+        return false;
+    }
+  }
+
+  void Evict() {
+    if (policy_.limit == RetentionPolicy::kAge) {
+      auto horizon =
+          time::steady_clock::now() - time::milliseconds(policy_.max);
+      while (!arrivals_.empty()) {
+        auto it = index_.find(*arrivals_.begin()->second);
+        if (it->second->inserted >= horizon) break;
+        Erase(it);
+      }
+    }
+    while (OverLimit()) {
+      if (policy_.eviction == RetentionPolicy::kLru) {
+        Erase(index_.find(lru_.back().data->getName()));
+        continue;
+      }
+      auto largest = by_publisher_.begin();
+      for (auto it = by_publisher_.begin(); it != by_publisher_.end(); ++it)
+        if (it->second.size() > largest->second.size()) largest = it;
+      Erase(index_.find(*largest->second.begin()->second));
+    }
+  }
+
+  void Erase(std::map<Name, std::list<Entry>::iterator>::iterator it) {
+    uint64_t arrival = it->second->arrival;
+    auto publisher = by_publisher_.find(it->first.getPrefix(id_size_));
+    publisher->second.erase(arrival);
+    if (publisher->second.empty()) by_publisher_.erase(publisher);
+    arrivals_.erase(arrival);
+    bytes_ -= it->second->size;
+    lru_.erase(it->second);
+    index_.erase(it);
+  }
+
+  RetentionPolicy policy_;
+  const std::size_t id_size_;
+  std::list<Entry> lru_;
+  std::map<Name, std::list<Entry>::iterator> index_;
+  Arrivals arrivals_;
+  std::map<Name, Arrivals> by_publisher_;
+  uint64_t arrivals_count_ = 0;
+  std::size_t bytes_ = 0;
+};
+
+}  // namespace app
+}  // namespace vsync
+}  // namespace ndn
+
+#endif  // DATA_STORE_HPP_
@@ -0,0 +1,54 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#ifndef EVENT_LOG_FORMAT_HPP_
+#define EVENT_LOG_FORMAT_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ndn {
+namespace vsync {
+namespace app {
+
+// Layout of the binary event log written by EventLog and read by
+// tools/event-log-decode. The file is a sequence of fixed-size records in
+// host byte order, each optionally followed by |payload| bytes padded to a
+// multiple of the record size.
+//
+// Strings (node IDs, data names) are written once, as a kString record whose
+// payload is the string, and referred to by ID afterwards.
+enum EventType : uint16_t {
+  kString = 0,        // a: string ID; payload: the string
+  kViewChange = 1,    // flags: is_leader; a: view number; b: leader ID;
+                      // payload: member IDs (uint32_t) of a view not
+                      // logged before, empty otherwise
+  kDataEvent = 2,     // flags: is_local; a: data name ID
+  kVectorChange = 3,  // a: index of the changed entry; payload: the entries
+                      // (uint64_t) of the version vector
+  kNodeStop = 4,
+};
+
+struct EventRecord {
+  double time;  // simulated time in seconds
+  uint16_t type;
+  uint16_t flags;
+  uint32_t node;  // string ID of the node ID
+  uint64_t a;
+  uint32_t b;
+  uint32_t payload;
+};
+
+static_assert(sizeof(EventRecord) == 32, "EventRecord must be 32 bytes");
+
+const char kEventLogMagic[8] = {'V', 'S', 'E', 'V', 'L', 'O', 'G', '1'};
+
+inline std::size_t PaddedPayload(std::size_t bytes) {
+  return (bytes + sizeof(EventRecord) - 1) / sizeof(EventRecord) *
+         sizeof(EventRecord);
+}
+
+}  // namespace app
+}  // namespace vsync
+}  // namespace ndn
+
+#endif  // EVENT_LOG_FORMAT_HPP_
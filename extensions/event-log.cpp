@@ -0,0 +1,138 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#include "event-log.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#include "ns3/simulator.h"
+
+namespace ns3 {
+namespace ndn {
+namespace vsync {
+
+using ::ndn::vsync::app::EventRecord;
+
+static const std::size_t kBufferSize = 1 << 20;
+
+EventLog& EventLog::Get() {
+  static EventLog log;
+  return log;
+}
+
+void EventLog::Open(const std::string& file_name) {
+  EventLog& log = Get();
+  Close();
+  log.file_ = std::fopen(file_name.c_str(), "wb");
+  if (log.file_ == nullptr)
+    throw std::runtime_error("Cannot open event log " + file_name);
+  log.buffer_.reserve(kBufferSize);
+  log.buffer_.assign(::ndn::vsync::app::kEventLogMagic,
+                     ::ndn::vsync::app::kEventLogMagic + 8);
+  log.strings_.clear();
+  log.views_.clear();
+  log.failed_ = false;
+}
+
+void EventLog::Close() {
+  EventLog& log = Get();
+  if (log.file_ == nullptr) return;
+  log.Flush();
+  std::fclose(log.file_);
+  log.file_ = nullptr;
+}
+
+void EventLog::ViewChange(const std::string& nid,
+                          const ::ndn::vsync::ViewID& vid,
+                          const ::ndn::vsync::ViewInfo& vinfo,
+                          bool is_leader) {
+  EventLog& log = Get();
+  if (log.file_ == nullptr) return;
+  uint32_t node = log.Intern(nid);
+  uint32_t leader = log.Intern(vid.second.toUri());
+
+  std::vector<uint32_t> members;
+  if (log.views_.emplace(vid.first, leader).second) {
+    for (std::size_t i = 0; i < vinfo.Size(); ++i)
+      members.push_back(log.Intern(vinfo.GetIDByIndex(i).first.toUri()));
+  }
+  log.Write(::ndn::vsync::app::kViewChange, is_leader, node, vid.first, leader,
+            members.data(), members.size() * sizeof(uint32_t));
+}
+
+void EventLog::DataEvent(const std::string& nid, const std::string& name,
+                         bool is_local) {
+  EventLog& log = Get();
+  if (log.file_ == nullptr) return;
+  uint32_t node = log.Intern(nid);
+  uint32_t data = log.Intern(name);
+  log.Write(::ndn::vsync::app::kDataEvent, is_local, node, data, 0, nullptr,
+            0);
+}
+
+void EventLog::VectorChange(const std::string& nid, std::size_t idx,
+                            const ::ndn::vsync::VersionVector& vv) {
+  EventLog& log = Get();
+  if (log.file_ == nullptr) return;
+  std::vector<uint64_t> entries(vv.begin(), vv.end());
+  log.Write(::ndn::vsync::app::kVectorChange, 0, log.Intern(nid), idx, 0,
+            entries.data(), entries.size() * sizeof(uint64_t));
+}
+
+void EventLog::NodeStop(const std::string& nid) {
+  EventLog& log = Get();
+  if (log.file_ == nullptr) return;
+  log.Write(::ndn::vsync::app::kNodeStop, 0, log.Intern(nid), 0, 0, nullptr,
+            0);
+}
+
+uint32_t EventLog::Intern(const std::string& s) {
+  auto it = strings_.find(s);
+  if (it != strings_.end()) return it->second;
+  uint32_t id = strings_.size();
+  strings_.emplace(s, id);
+  Write(::ndn::vsync::app::kString, 0, 0, id, 0, s.data(), s.size());
+  return id;
+}
+
+void EventLog::Write(uint16_t type, uint16_t flags, uint32_t node, uint64_t a,
+                     uint32_t b, const void* payload, uint32_t payload_size) {
+  EventRecord r;
+  r.time = Simulator::Now().GetSeconds();
+  r.type = type;
+  r.flags = flags;
+  r.node = node;
+  r.a = a;
+  r.b = b;
+  r.payload = payload_size;
+
+  std::size_t padded = ::ndn::vsync::app::PaddedPayload(payload_size);
+  if (buffer_.size() + sizeof(r) + padded > kBufferSize) Flush();
+  const char* p = reinterpret_cast<const char*>(&r);
+  buffer_.insert(buffer_.end(), p, p + sizeof(r));
+  if (padded > 0) {
+    std::size_t offset = buffer_.size();
+    buffer_.resize(offset + padded, 0);
+    std::memcpy(buffer_.data() + offset, payload, payload_size);
+  }
+}
+
+void EventLog::Flush() {
+  if (!buffer_.empty() && !failed_) {
+    std::size_t written = std::fwrite(buffer_.data(), 1, buffer_.size(), file_);
+    if (written < buffer_.size()) {
+      // The rest of the log would not decode past the gap.
+      std::cerr << "ERROR: event log write failed after " << written << " of "
+                << buffer_.size() << " bytes: " << std::strerror(errno)
+                << "; no further events are written" << std::endl;
+      failed_ = true;
+    }
+  }
+  buffer_.clear();
+}
+
+}  // namespace vsync
+}  // namespace ndn
+}  // namespace ns3
@@ -0,0 +1,80 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#ifndef EVENT_LOG_HPP_
+#define EVENT_LOG_HPP_
+
+#include <cstdio>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include "event-log-format.hpp"
+#include "node.hpp"
+
+namespace ns3 {
+namespace ndn {
+namespace vsync {
+
+// Process-wide binary log of sync events, for trace sinks that would
+// otherwise format every event as text. Records have a fixed size (see
+// event-log-format.hpp), strings are interned, and writes go through an
+// in-memory buffer. Decode a log with ./build/event-log-decode.
+//
+// All calls are no-ops until Open().
+class EventLog {
+ public:
+  static void Open(const std::string& file_name);
+
+  static bool IsOpen() { return Get().file_ != nullptr; }
+
+  // Flushes the buffer and closes the file.
+  static void Close();
+
+  static void ViewChange(const std::string& nid,
+                         const ::ndn::vsync::ViewID& vid,
+                         const ::ndn::vsync::ViewInfo& vinfo, bool is_leader);
+
+  static void DataEvent(const std::string& nid, const std::string& name,
+                        bool is_local);
+
+  static void VectorChange(const std::string& nid, std::size_t idx,
+                           const ::ndn::vsync::VersionVector& vv);
+
+  static void NodeStop(const std::string& nid);
+
+ private:
+  EventLog() = default;
+
+  ~EventLog() {
+    if (file_ == nullptr) return;
+    Flush();
+    std::fclose(file_);
+  }
+
+  static EventLog& Get();
+
+  uint32_t Intern(const std::string& s);
+
+  void Write(uint16_t type, uint16_t flags, uint32_t node, uint64_t a,
+             uint32_t b, const void* payload, uint32_t payload_size);
+
+  void Flush();
+
+ private:
+  std::FILE* file_ = nullptr;
+  // Set after a short write.
+  bool failed_ = false;
+  std::vector<char> buffer_;
+  std::unordered_map<std::string, uint32_t> strings_;
+  // Views whose members have been logged.
+  std::set<std::pair<uint64_t, uint32_t>> views_;
+};
+
+}  // namespace vsync
+}  // namespace ndn
+}  // namespace ns3
+
+#endif  // EVENT_LOG_HPP_
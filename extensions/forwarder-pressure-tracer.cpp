@@ -0,0 +1,174 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#include "forwarder-pressure-tracer.hpp"
+
+#include <fstream>
+
+#include "ns3/log.h"
+#include "ns3/names.h"
+#include "ns3/node-list.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+
+#include "ns3/ndnSIM/model/ndn-l3-protocol.hpp"
+
+#include "node.hpp"
+
+NS_LOG_COMPONENT_DEFINE("ns3.ndn.vsync.ForwarderPressureTracer");
+
+namespace ns3 {
+namespace ndn {
+namespace vsync {
+
+static std::list<std::shared_ptr<ForwarderPressureTracer>> g_tracers;
+
+static void DestroyTracers() { g_tracers.clear(); }
+
+void ForwarderPressureTracer::InstallAll(const std::string& file,
+                                         Time period) {
+  NodeContainer nodes;
+  for (auto node = NodeList::Begin(); node != NodeList::End(); ++node)
+    nodes.Add(*node);
+  Install(nodes, file, period);
+}
+
+void ForwarderPressureTracer::Install(const NodeContainer& nodes,
+                                      const std::string& file, Time period) {
+  auto os = std::make_shared<std::ofstream>(
+      file.c_str(), std::ios_base::out | std::ios_base::trunc);
+  if (!os->is_open()) {
+    NS_LOG_ERROR("Cannot open " << file << " for writing");
+    return;
+  }
+  PrintHeader(*os);
+
+  if (g_tracers.empty()) Simulator::ScheduleDestroy(&DestroyTracers);
+  for (auto node = nodes.Begin(); node != nodes.End(); ++node) {
+    if ((*node)->GetObject<L3Protocol>() == nullptr) continue;
+    g_tracers.push_back(
+        std::make_shared<ForwarderPressureTracer>(os, *node, period));
+  }
+}
+
+ForwarderPressureTracer::ForwarderPressureTracer(
+    std::shared_ptr<std::ostream> os, Ptr<Node> node, Time period)
+    : os_(os), node_(node), period_(period) {
+  node_name_ = Names::FindName(node_);
+  if (node_name_.empty()) node_name_ = std::to_string(node_->GetId());
+  forwarder_ = node_->GetObject<L3Protocol>()->getForwarder();
+  last_pit_size_.fill(0);
+  Connect();
+  print_event_ =
+      Simulator::Schedule(period_, &ForwarderPressureTracer::PeriodicPrinter,
+                          this);
+}
+
+int ForwarderPressureTracer::Classify(const Name& name) {
+  static const Name kLocalhost("/localhost");
+  if (kLocalhost.isPrefixOf(name)) return -1;
+  if (::ndn::vsync::kSyncPrefix.isPrefixOf(name)) return kSync;
+  return kData;
+}
+
+void ForwarderPressureTracer::PrintHeader(std::ostream& os) {
+  os << "Time\tNode\tClass\tInInterests\tCsHits\tCsMisses\tAggregated\t"
+        "Satisfied\tExpired\tPitEntries\tCsEntries\tCsEvictions\n";
+}
+
+void ForwarderPressureTracer::Connect() {
+  Ptr<L3Protocol> l3 = node_->GetObject<L3Protocol>();
+  l3->TraceConnectWithoutContext(
+      "InInterests",
+      MakeCallback(&ForwarderPressureTracer::InInterests, this));
+  l3->TraceConnectWithoutContext(
+      "OutData", MakeCallback(&ForwarderPressureTracer::OutData, this));
+  l3->TraceConnectWithoutContext(
+      "SatisfiedInterests",
+      MakeCallback(&ForwarderPressureTracer::SatisfiedInterests, this));
+  l3->TraceConnectWithoutContext(
+      "TimedOutInterests",
+      MakeCallback(&ForwarderPressureTracer::TimedOutInterests, this));
+}
+
+void ForwarderPressureTracer::PeriodicPrinter() {
+  std::array<uint64_t, kNumClasses> pit_size;
+  pit_size.fill(0);
+  for (const nfd::pit::Entry& entry : forwarder_->getPit()) {
+    int c = Classify(entry.getName());
+    if (c >= 0) ++pit_size[c];
+  }
+
+  uint64_t cs_size = forwarder_->getCs().size();
+  uint64_t cs_growth = cs_size > last_cs_size_ ? cs_size - last_cs_size_ : 0;
+  uint64_t evictions =
+      cs_admissions_ > cs_growth ? cs_admissions_ - cs_growth : 0;
+
+  double now = Simulator::Now().ToDouble(Time::S);
+  for (int c = 0; c < kNumClasses; ++c) {
+    const Counters& cnt = counters_[c];
+    uint64_t hits = cnt.out_data > cnt.satisfied_fanout
+                        ? cnt.out_data - cnt.satisfied_fanout
+                        : 0;
+    if (hits > cnt.in_interests) hits = cnt.in_interests;
+    uint64_t misses = cnt.in_interests - hits;
+    // Every PIT entry is eventually satisfied or expires, so the entries
+    // created in this period are those that left plus the net growth.
+    int64_t created = static_cast<int64_t>(cnt.satisfied + cnt.expired) +
+                      static_cast<int64_t>(pit_size[c]) -
+                      static_cast<int64_t>(last_pit_size_[c]);
+    int64_t aggregated = static_cast<int64_t>(misses) - created;
+    if (aggregated < 0) aggregated = 0;
+
+    *os_ << now << "\t" << node_name_ << "\t"
+         << (c == kSync ? "SyncInterests" : "DataInterests") << "\t"
+         << cnt.in_interests << "\t" << hits << "\t" << misses << "\t"
+         << aggregated << "\t" << cnt.satisfied << "\t" << cnt.expired
+         << "\t" << pit_size[c] << "\t" << cs_size << "\t" << evictions
+         << "\n";
+  }
+
+  counters_.fill(Counters());
+  last_pit_size_ = pit_size;
+  last_cs_size_ = cs_size;
+  cs_admissions_ = 0;
+
+  print_event_ =
+      Simulator::Schedule(period_, &ForwarderPressureTracer::PeriodicPrinter,
+                          this);
+}
+
+void ForwarderPressureTracer::InInterests(const Interest& interest,
+                                          const nfd::Face& face) {
+  int c = Classify(interest.getName());
+  if (c >= 0) ++counters_[c].in_interests;
+}
+
+void ForwarderPressureTracer::OutData(const Data& data,
+                                      const nfd::Face& face) {
+  int c = Classify(data.getName());
+  if (c >= 0) ++counters_[c].out_data;
+}
+
+void ForwarderPressureTracer::SatisfiedInterests(const nfd::pit::Entry& entry,
+                                                 const nfd::Face& face,
+                                                 const Data& data) {
+  int c = Classify(entry.getName());
+  if (c < 0) return;
+  ++counters_[c].satisfied;
+  counters_[c].satisfied_fanout += entry.getInRecords().size();
+  // One incoming Data may satisfy several PIT entries back to back but is
+  // admitted into the CS only once.
+  if (data.getName() != last_admitted_) {
+    last_admitted_ = data.getName();
+    ++cs_admissions_;
+  }
+}
+
+void ForwarderPressureTracer::TimedOutInterests(const nfd::pit::Entry& entry) {
+  int c = Classify(entry.getName());
+  if (c >= 0) ++counters_[c].expired;
+}
+
+}  // namespace vsync
+}  // namespace ndn
+}  // namespace ns3
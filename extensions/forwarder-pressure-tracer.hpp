@@ -0,0 +1,92 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#ifndef FORWARDER_PRESSURE_TRACER_HPP_
+#define FORWARDER_PRESSURE_TRACER_HPP_
+
+#include <array>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <ostream>
+#include <string>
+
+#include "ns3/event-id.h"
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+
+#include "ns3/ndnSIM/NFD/daemon/fw/forwarder.hpp"
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+namespace ns3 {
+namespace ndn {
+namespace vsync {
+
+// Periodically samples content store and PIT pressure on a forwarder, split
+// into sync interests (under ::ndn::vsync::kSyncPrefix) and data fetches.
+//
+// NFD does not export CS hit/miss counters, so they are derived from the L3
+// trace sources: every Data sent downstream that is not accounted for by a
+// satisfied PIT entry's in-records must have been answered from the CS.
+// Aggregated interests are the misses that did not create a new PIT entry.
+// Evictions are estimated from CS admissions versus the change in CS size.
+class ForwarderPressureTracer {
+ public:
+  static void InstallAll(const std::string& file, Time period);
+
+  static void Install(const NodeContainer& nodes, const std::string& file,
+                      Time period);
+
+  ForwarderPressureTracer(std::shared_ptr<std::ostream> os, Ptr<Node> node,
+                          Time period);
+
+ private:
+  enum PrefixClass { kSync = 0, kData = 1, kNumClasses = 2 };
+
+  struct Counters {
+    uint64_t in_interests = 0;
+    uint64_t out_data = 0;
+    uint64_t satisfied = 0;
+    uint64_t satisfied_fanout = 0;
+    uint64_t expired = 0;
+  };
+
+  static int Classify(const Name& name);
+
+  static void PrintHeader(std::ostream& os);
+
+  void Connect();
+
+  void PeriodicPrinter();
+
+  void InInterests(const Interest& interest, const nfd::Face& face);
+
+  void OutData(const Data& data, const nfd::Face& face);
+
+  void SatisfiedInterests(const nfd::pit::Entry& entry,
+                          const nfd::Face& face, const Data& data);
+
+  void TimedOutInterests(const nfd::pit::Entry& entry);
+
+ private:
+  std::shared_ptr<std::ostream> os_;
+  Ptr<Node> node_;
+  std::string node_name_;
+  std::shared_ptr<nfd::Forwarder> forwarder_;
+  Time period_;
+  EventId print_event_;
+
+  std::array<Counters, kNumClasses> counters_;
+  std::array<uint64_t, kNumClasses> last_pit_size_;
+  uint64_t cs_admissions_ = 0;
+  uint64_t last_cs_size_ = 0;
+  // Name of the Data last counted as admitted. A Data packet's address can
+  // be reused once it is freed, so it does not identify the packet.
+  Name last_admitted_;
+};
+
+}  // namespace vsync
+}  // namespace ndn
+}  // namespace ns3
+
+#endif  // FORWARDER_PRESSURE_TRACER_HPP_
@@ -0,0 +1,126 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#include "memory-forwarder.hpp"
+
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include "ns3/ndnSIM/ndn-cxx/mgmt/nfd/control-parameters.hpp"
+
+NS_LOG_COMPONENT_DEFINE("ns3.ndn.vsync.MemoryForwarder");
+
+namespace ns3 {
+namespace ndn {
+namespace vsync {
+
+static const Name kRegisterPrefix("/localhost/nfd/rib/register");
+
+static void DeliverInterest(MemoryForwarder::FacePtr face, Interest interest) {
+  face->receive(interest);
+}
+
+static void DeliverData(MemoryForwarder::FacePtr face, Data data) {
+  face->receive(data);
+}
+
+MemoryForwarder::MemoryForwarder(Time delay, Time jitter)
+    : delay_(delay), jitter_(jitter) {
+  jitter_rv_ = CreateObject<UniformRandomVariable>();
+  jitter_rv_->SetAttribute("Min", DoubleValue(0.0));
+  jitter_rv_->SetAttribute("Max", DoubleValue(jitter.GetSeconds()));
+}
+
+void MemoryForwarder::AddFace(FacePtr face) {
+  std::size_t id = faces_.size();
+  faces_.push_back({face, nullptr});
+  face->onSendInterest.connect(
+      [this, id](const Interest& interest) { OnInterest(id, interest); });
+  face->onSendData.connect([this, id](const Data& data) { OnData(id, data); });
+}
+
+std::size_t MemoryForwarder::AddPort(SendFn send) {
+  faces_.push_back({nullptr, send});
+  return faces_.size() - 1;
+}
+
+void MemoryForwarder::AddRoute(const Name& prefix, std::size_t face) {
+  fib_.emplace_back(prefix, face);
+}
+
+void MemoryForwarder::ReceiveFromPort(std::size_t port, const Block& wire) {
+  if (wire.type() == ::ndn::tlv::Interest)
+    OnInterest(port, Interest(wire));
+  else if (wire.type() == ::ndn::tlv::Data)
+    OnData(port, Data(wire));
+}
+
+Time MemoryForwarder::NextDelay() {
+  return delay_ + Seconds(jitter_rv_->GetValue());
+}
+
+void MemoryForwarder::OnInterest(std::size_t from, const Interest& interest) {
+  const auto& name = interest.getName();
+
+  // The face answers its own registration commands; only learn the route.
+  if (kRegisterPrefix.isPrefixOf(name)) {
+    ::ndn::nfd::ControlParameters params(
+        name.get(kRegisterPrefix.size()).blockFromValue());
+    NS_LOG_DEBUG("face " << from << " registers " << params.getName());
+    fib_.emplace_back(params.getName(), from);
+    return;
+  }
+
+  uint64_t tag = next_tag_++;
+  pit_[name][from] = tag;
+  Simulator::Schedule(
+      MilliSeconds(interest.getInterestLifetime().count()),
+      &MemoryForwarder::Expire, this, name, from, tag);
+
+  bool from_port = faces_[from].face == nullptr;
+  std::vector<bool> sent(faces_.size(), false);
+  for (const auto& route : fib_) {
+    std::size_t to = route.second;
+    if (to == from || sent[to] || !route.first.isPrefixOf(name)) continue;
+    if (from_port && faces_[to].face == nullptr) continue;
+    sent[to] = true;
+    ++interests_;
+    if (faces_[to].face == nullptr)
+      faces_[to].send(interest.wireEncode());
+    else
+      Simulator::Schedule(NextDelay(), &DeliverInterest, faces_[to].face,
+                          interest);
+  }
+}
+
+void MemoryForwarder::OnData(std::size_t from, const Data& data) {
+  const auto& name = data.getName();
+  for (std::size_t k = 0; k <= name.size(); ++k) {
+    auto entry = pit_.find(name.getPrefix(k));
+    if (entry == pit_.end()) continue;
+    for (const auto& pending : entry->second) {
+      if (pending.first == from) continue;
+      ++data_;
+      const auto& to = faces_[pending.first];
+      if (to.face == nullptr)
+        to.send(data.wireEncode());
+      else
+        Simulator::Schedule(NextDelay(), &DeliverData, to.face, data);
+    }
+    pit_.erase(entry);
+  }
+}
+
+void MemoryForwarder::Expire(const Name& name, std::size_t face,
+                             uint64_t tag) {
+  auto entry = pit_.find(name);
+  if (entry == pit_.end()) return;
+  auto pending = entry->second.find(face);
+  if (pending == entry->second.end() || pending->second != tag) return;
+  entry->second.erase(pending);
+  if (entry->second.empty()) pit_.erase(entry);
+}
+
+}  // namespace vsync
+}  // namespace ndn
+}  // namespace ns3
@@ -0,0 +1,92 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#ifndef MEMORY_FORWARDER_HPP_
+#define MEMORY_FORWARDER_HPP_
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "ns3/random-variable-stream.h"
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+#include "ns3/ndnSIM/ndn-cxx/util/dummy-client-face.hpp"
+
+namespace ns3 {
+namespace ndn {
+namespace vsync {
+
+// A minimal in-memory forwarder connecting DummyClientFaces, used to run
+// many sync nodes in one process without the NDN stack and link models.
+//
+// The FIB is learnt from the prefix registrations the faces send. An
+// interest goes to every other face with a registered prefix of its name
+// and leaves a PIT entry for its lifetime; a Data goes to the faces with a
+// pending entry for a prefix of its name. Every delivery takes the
+// configured delay plus a uniform jitter.
+//
+// Forwarders of different shards are joined by ports. A port is a face
+// whose packets are handed, wire-encoded, to a transport to the other
+// shard; the receiving forwarder applies the delay. Packets that arrive on
+// a port are never sent out another port, so a multicast crosses each
+// shard boundary once.
+class MemoryForwarder {
+ public:
+  using FacePtr = std::shared_ptr<::ndn::util::DummyClientFace>;
+  using SendFn = std::function<void(const Block& wire)>;
+
+  MemoryForwarder(Time delay, Time jitter);
+
+  void AddFace(FacePtr face);
+
+  // Returns the face ID of the new port.
+  std::size_t AddPort(SendFn send);
+
+  // Adds a static route, e.g. for the nodes of another shard behind a port.
+  void AddRoute(const Name& prefix, std::size_t face);
+
+  void ReceiveFromPort(std::size_t port, const Block& wire);
+
+  uint64_t GetForwardedInterests() const { return interests_; }
+
+  uint64_t GetForwardedData() const { return data_; }
+
+ private:
+  void OnInterest(std::size_t from, const Interest& interest);
+
+  void OnData(std::size_t from, const Data& data);
+
+  void Expire(const Name& name, std::size_t face, uint64_t tag);
+
+  Time NextDelay();
+
+ private:
+  Time delay_;
+  Time jitter_;
+  Ptr<UniformRandomVariable> jitter_rv_;
+
+  struct Port {
+    FacePtr face;
+    SendFn send;
+  };
+
+  std::vector<Port> faces_;
+  std::vector<std::pair<Name, std::size_t>> fib_;
+  // Pending interests by name: requesting face and a tag of the entry.
+  std::map<Name, std::map<std::size_t, uint64_t>> pit_;
+  uint64_t next_tag_ = 0;
+
+  uint64_t interests_ = 0;
+  uint64_t data_ = 0;
+};
+
+}  // namespace vsync
+}  // namespace ndn
+}  // namespace ns3
+
+#endif  // MEMORY_FORWARDER_HPP_
@@ -0,0 +1,181 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#include "queue-monitor.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+#include "ns3/channel.h"
+#include "ns3/log.h"
+#include "ns3/names.h"
+#include "ns3/node-list.h"
+#include "ns3/node.h"
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/ppp-header.h"
+#include "ns3/simulator.h"
+
+#include "ns3/ndnSIM/ndn-cxx/lp/packet.hpp"
+
+#include "node.hpp"
+
+NS_LOG_COMPONENT_DEFINE("ns3.ndn.vsync.QueueMonitor");
+
+namespace ns3 {
+namespace ndn {
+namespace vsync {
+
+static std::string NodeName(Ptr<Node> node) {
+  std::string name = Names::FindName(node);
+  return name.empty() ? std::to_string(node->GetId()) : name;
+}
+
+void QueueMonitor::InstallAll() {
+  NodeContainer nodes;
+  for (auto node = NodeList::Begin(); node != NodeList::End(); ++node)
+    nodes.Add(*node);
+  Install(nodes);
+}
+
+void QueueMonitor::Install(const NodeContainer& nodes) {
+  bool first = links_.empty();
+  for (auto node = nodes.Begin(); node != nodes.End(); ++node)
+    for (uint32_t i = 0; i < (*node)->GetNDevices(); ++i)
+      Install((*node)->GetDevice(i));
+  if (first && !links_.empty() && period_.IsStrictlyPositive())
+    Simulator::Schedule(period_, &QueueMonitor::Sample, this);
+}
+
+void QueueMonitor::Install(Ptr<NetDevice> device) {
+  Ptr<PointToPointNetDevice> p2p = DynamicCast<PointToPointNetDevice>(device);
+  if (p2p == nullptr || p2p->GetChannel() == nullptr) return;
+
+  Ptr<Channel> channel = p2p->GetChannel();
+  std::string peer = "?";
+  for (std::size_t i = 0; i < channel->GetNDevices(); ++i)
+    if (channel->GetDevice(i) != device)
+      peer = NodeName(channel->GetDevice(i)->GetNode());
+
+  links_.emplace_back(new Link);
+  Link* link = links_.back().get();
+  link->name = NodeName(device->GetNode()) + "->" + peer;
+  link->queue = p2p->GetQueue();
+  link->queue->TraceConnectWithoutContext(
+      "Enqueue", MakeBoundCallback(&QueueMonitor::Enqueue, link));
+  link->queue->TraceConnectWithoutContext(
+      "Dequeue", MakeBoundCallback(&QueueMonitor::Dequeue, link));
+  link->queue->TraceConnectWithoutContext(
+      "Drop", MakeBoundCallback(&QueueMonitor::Drop, link));
+}
+
+void QueueMonitor::Sample() {
+  for (const auto& link : links_) {
+    ++link->samples;
+    link->length_sum += link->queue->GetNPackets();
+  }
+  Simulator::Schedule(period_, &QueueMonitor::Sample, this);
+}
+
+int QueueMonitor::Classify(Ptr<const Packet> packet) {
+  Ptr<Packet> copy = packet->Copy();
+  PppHeader ppp;
+  copy->RemoveHeader(ppp);
+  std::vector<uint8_t> wire(copy->GetSize());
+  copy->CopyData(wire.data(), wire.size());
+
+  try {
+    Block block(wire.data(), wire.size());
+    if (block.type() == ::ndn::lp::tlv::LpPacket) {
+      ::ndn::lp::Packet lp(block);
+      if (!lp.has<::ndn::lp::FragmentField>()) return kNumClasses;
+      auto fragment = lp.get<::ndn::lp::FragmentField>();
+      block = Block(&*fragment.first, fragment.second - fragment.first);
+    }
+    if (block.type() == ::ndn::tlv::Data) return TrafficCounter::kData;
+    if (block.type() != ::ndn::tlv::Interest) return kNumClasses;
+    block.parse();
+    Name name(block.get(::ndn::tlv::Name));
+    return ::ndn::vsync::kSyncPrefix.isPrefixOf(name)
+               ? TrafficCounter::kSyncInterest
+               : TrafficCounter::kDataInterest;
+  } catch (const ::ndn::tlv::Error&) {
+    return kNumClasses;
+  }
+}
+
+void QueueMonitor::Enqueue(Link* link, Ptr<const Packet> packet) {
+  int c = Classify(packet);
+  if (c < kNumClasses) ++link->enqueued[c];
+  link->bytes += packet->GetSize();
+  link->arrivals.push_back(Simulator::Now().GetSeconds());
+  link->length_max = std::max(link->length_max, link->queue->GetNPackets());
+}
+
+void QueueMonitor::Dequeue(Link* link, Ptr<const Packet> packet) {
+  if (link->arrivals.empty()) return;
+  double delay = Simulator::Now().GetSeconds() - link->arrivals.front();
+  link->arrivals.pop_front();
+  ++link->departures;
+  link->delay_sum += delay;
+  link->delay_max = std::max(link->delay_max, delay);
+}
+
+void QueueMonitor::Drop(Link* link, Ptr<const Packet> packet) {
+  int c = Classify(packet);
+  NS_LOG_DEBUG("drop on " << link->name << ", class " << c);
+  if (c < kNumClasses) ++link->dropped[c];
+}
+
+void QueueMonitor::Report(const std::string& file, std::size_t worst) {
+  std::fstream fs(file, std::ios_base::out | std::ios_base::trunc);
+  fs << "Link\tSyncInterests\tDataInterests\tData\tBytes\tSyncDrops\t"
+        "DataInterestDrops\tDataDrops\tMeanQueue\tMaxQueue\tMeanDelay\t"
+        "MaxDelay\n";
+
+  std::array<uint64_t, kNumClasses> drops{};
+  std::vector<const Link*> active;
+  for (const auto& link : links_) {
+    if (link->bytes == 0) continue;
+    active.push_back(link.get());
+    for (int c = 0; c < kNumClasses; ++c) drops[c] += link->dropped[c];
+
+    fs << link->name;
+    for (int c = 0; c < kNumClasses; ++c) fs << '\t' << link->enqueued[c];
+    fs << '\t' << link->bytes;
+    for (int c = 0; c < kNumClasses; ++c) fs << '\t' << link->dropped[c];
+    fs << '\t'
+       << (link->samples > 0
+               ? static_cast<double>(link->length_sum) / link->samples
+               : 0.0)
+       << '\t' << link->length_max << '\t'
+       << (link->departures > 0 ? link->delay_sum / link->departures : 0.0)
+       << '\t' << link->delay_max << '\n';
+  }
+
+  std::cout << "Sync interest queue drops is: "
+            << drops[TrafficCounter::kSyncInterest] << std::endl;
+  std::cout << "Data interest queue drops is: "
+            << drops[TrafficCounter::kDataInterest] << std::endl;
+  std::cout << "Data queue drops is: " << drops[TrafficCounter::kData]
+            << std::endl;
+
+  auto total_drops = [](const Link* l) {
+    return l->dropped[0] + l->dropped[1] + l->dropped[2];
+  };
+  std::sort(active.begin(), active.end(),
+            [&](const Link* a, const Link* b) {
+              if (total_drops(a) != total_drops(b))
+                return total_drops(a) > total_drops(b);
+              return a->delay_max > b->delay_max;
+            });
+  if (active.size() > worst) active.resize(worst);
+  std::cout << "Worst links (drops, max queue, max queueing delay):"
+            << std::endl;
+  for (const Link* l : active)
+    std::cout << "  " << l->name << ": " << total_drops(l) << ", "
+              << l->length_max << ", " << l->delay_max << "s" << std::endl;
+}
+
+}  // namespace vsync
+}  // namespace ndn
+}  // namespace ns3
@@ -0,0 +1,91 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#ifndef QUEUE_MONITOR_HPP_
+#define QUEUE_MONITOR_HPP_
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ns3/net-device.h"
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+#include "ns3/queue.h"
+
+#include "traffic-counter.hpp"
+
+namespace ns3 {
+namespace ndn {
+namespace vsync {
+
+// Watches the transmit queues of point-to-point devices to tell which links
+// delay or drop sync traffic.
+//
+// Every enqueue and drop is classified as a sync interest, data interest or
+// Data (as in TrafficCounter) and counted per link; the time each packet
+// spends in the queue is measured from its enqueue to its dequeue. Queue
+// length is tracked exactly for the maximum and sampled every |period| for
+// the mean. Everything is aggregated in memory, so monitoring every link of
+// a large topology only costs a few counters per link.
+class QueueMonitor {
+ public:
+  explicit QueueMonitor(Time period) : period_(period) {}
+
+  void InstallAll();
+
+  void Install(const NodeContainer& nodes);
+
+  // Writes the statistics of every link that carried traffic to |file| and
+  // prints the totals and the |worst| links, by drops and then by longest
+  // queueing delay, to stdout.
+  void Report(const std::string& file, std::size_t worst = 10);
+
+ private:
+  enum { kNumClasses = TrafficCounter::kNumClasses };
+
+  struct Link {
+    std::string name;
+    Ptr<Queue> queue;
+
+    std::array<uint64_t, kNumClasses> enqueued{};
+    std::array<uint64_t, kNumClasses> dropped{};
+    uint64_t bytes = 0;
+
+    std::deque<double> arrivals;
+    uint64_t departures = 0;
+    double delay_sum = 0.0;
+    double delay_max = 0.0;
+
+    uint64_t samples = 0;
+    uint64_t length_sum = 0;
+    uint32_t length_max = 0;
+  };
+
+  void Install(Ptr<NetDevice> device);
+
+  void Sample();
+
+  // Returns the TrafficCounter::PacketClass of a packet in a transmit queue,
+  // or kNumClasses if it is not an NDN packet.
+  static int Classify(Ptr<const Packet> packet);
+
+  static void Enqueue(Link* link, Ptr<const Packet> packet);
+
+  static void Dequeue(Link* link, Ptr<const Packet> packet);
+
+  static void Drop(Link* link, Ptr<const Packet> packet);
+
+ private:
+  Time period_;
+  std::vector<std::unique_ptr<Link>> links_;
+};
+
+}  // namespace vsync
+}  // namespace ndn
+}  // namespace ns3
+
+#endif  // QUEUE_MONITOR_HPP_
@@ -0,0 +1,102 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#include "quiescence-monitor.hpp"
+
+#include <iostream>
+#include <stdexcept>
+
+#include "ns3/callback.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+NS_LOG_COMPONENT_DEFINE("ns3.ndn.vsync.QuiescenceMonitor");
+
+namespace ns3 {
+namespace ndn {
+namespace vsync {
+
+void QuiescenceMonitor::Connect(Ptr<Application> app,
+                                const std::string& nid) {
+  if (!app->TraceConnect(
+          "PublishingDone", nid,
+          MakeCallback(&QuiescenceMonitor::PublishingDone, this)))
+    throw std::invalid_argument(
+        "Cannot stop when quiescent: the app of " + nid + " (" +
+        app->GetInstanceTypeId().GetName() +
+        ") has no PublishingDone trace and publishes until it stops");
+  members_.insert(nid);
+  publishing_.insert(nid);
+  app->TraceConnect("DataEvent", nid,
+                    MakeCallback(&QuiescenceMonitor::DataEvent, this));
+}
+
+void QuiescenceMonitor::AddDeparture(const std::string& nid, Time time) {
+  Simulator::Schedule(time, &QuiescenceMonitor::Leave, this, nid);
+}
+
+void QuiescenceMonitor::DataEvent(std::string nid,
+                                  std::shared_ptr<const Data> data,
+                                  bool is_local) {
+  auto name = data->getName().toUri();
+  if (is_local) {
+    auto& receivers = outstanding_[name];
+    receivers = members_;
+    receivers.erase(nid);
+    if (receivers.empty()) outstanding_.erase(name);
+    Simulator::Cancel(stop_event_);
+  } else {
+    auto entry = outstanding_.find(name);
+    if (entry == outstanding_.end()) return;
+    entry->second.erase(nid);
+    if (entry->second.empty()) outstanding_.erase(entry);
+  }
+  MaybeStop();
+}
+
+void QuiescenceMonitor::PublishingDone(std::string nid) {
+  NS_LOG_INFO("node " << nid << " published its last message");
+  publishing_.erase(nid);
+  MaybeStop();
+}
+
+void QuiescenceMonitor::Leave(std::string nid) {
+  members_.erase(nid);
+  publishing_.erase(nid);
+  for (auto iter = outstanding_.begin(); iter != outstanding_.end();) {
+    iter->second.erase(nid);
+    if (iter->second.empty())
+      iter = outstanding_.erase(iter);
+    else
+      ++iter;
+  }
+  MaybeStop();
+}
+
+void QuiescenceMonitor::MaybeStop() {
+  if (!publishing_.empty() || !outstanding_.empty()) return;
+  Simulator::Cancel(stop_event_);
+  stop_event_ = Simulator::Schedule(grace_, &QuiescenceMonitor::Stop, this);
+}
+
+void QuiescenceMonitor::Stop() {
+  stop_time_ = Simulator::Now();
+  NS_LOG_INFO("group quiescent, stopping at " << stop_time_.GetSeconds()
+                                              << "s");
+  Simulator::Stop();
+}
+
+void QuiescenceMonitor::Report(Time run_time) {
+  if (stop_time_.IsNegative()) {
+    std::cout << "Group never became quiescent." << std::endl;
+    return;
+  }
+  std::cout << "Quiescence stop time is: " << stop_time_.GetSeconds()
+            << " seconds." << std::endl;
+  std::cout << "Simulated time saved is: "
+            << (run_time - stop_time_).GetSeconds() << " seconds."
+            << std::endl;
+}
+
+}  // namespace vsync
+}  // namespace ndn
+}  // namespace ns3
@@ -0,0 +1,70 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#ifndef QUIESCENCE_MONITOR_HPP_
+#define QUIESCENCE_MONITOR_HPP_
+
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+
+#include "ns3/application.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+namespace ns3 {
+namespace ndn {
+namespace vsync {
+
+// Stops the simulation once a sync group has nothing left to do.
+//
+// The monitor follows the DataEvent traces of the members: a data item is
+// outstanding until every member that was in the group when it was
+// published has received it, or has left. The group is quiescent when no
+// item is outstanding and every member has fired PublishingDone; it then
+// stops the simulator after |grace|, unless new data shows up in the
+// meantime.
+class QuiescenceMonitor {
+ public:
+  explicit QuiescenceMonitor(Time grace) : grace_(grace) {}
+
+  // Throws std::invalid_argument if |app| has no PublishingDone trace, as
+  // the FIFO and causal apps, which publish until they stop: the group
+  // would never become quiescent.
+  void Connect(Ptr<Application> app, const std::string& nid);
+
+  // Records that member |nid| leaves the group at |time|.
+  void AddDeparture(const std::string& nid, Time time);
+
+  // Prints when the simulation was stopped and how much of |run_time| was
+  // saved to stdout.
+  void Report(Time run_time);
+
+ private:
+  void DataEvent(std::string nid, std::shared_ptr<const Data> data,
+                 bool is_local);
+
+  void PublishingDone(std::string nid);
+
+  void Leave(std::string nid);
+
+  void MaybeStop();
+
+  void Stop();
+
+ private:
+  Time grace_;
+  std::set<std::string> members_;
+  std::set<std::string> publishing_;
+  // Receivers still missing each outstanding data item, by data name.
+  std::unordered_map<std::string, std::set<std::string>> outstanding_;
+  EventId stop_event_;
+  Time stop_time_ = Seconds(-1.0);
+};
+
+}  // namespace vsync
+}  // namespace ndn
+}  // namespace ns3
+
+#endif  // QUIESCENCE_MONITOR_HPP_
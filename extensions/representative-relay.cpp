@@ -0,0 +1,152 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#include "representative-relay.hpp"
+
+#include <cstdlib>
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+NS_LOG_COMPONENT_DEFINE("ns3.ndn.vsync.RepresentativeRelay");
+
+namespace ns3 {
+namespace ndn {
+namespace vsync {
+
+RepresentativeRelay::RepresentativeRelay(Ptr<SimpleNodeApp> gateway,
+                                         Time window, Time delay,
+                                         uint32_t hops)
+    : gateway_(gateway), window_(window), delay_(delay), hops_(hops) {
+  gateway_->TraceConnectWithoutContext(
+      "MessageEvent",
+      MakeCallback(&RepresentativeRelay::GatewayMessage, this));
+}
+
+void RepresentativeRelay::AddMember(Ptr<SimpleNodeApp> member) {
+  std::string index = std::to_string(members_.size());
+  members_.push_back(member);
+  member->TraceConnect(
+      "MessageEvent", index,
+      MakeCallback(&RepresentativeRelay::MemberMessage, this));
+  member->TraceConnect(
+      "ViewChange", index,
+      MakeCallback(&RepresentativeRelay::MemberViewChange, this));
+}
+
+// Messages are named <publisher>:<sequence number>, numbered from 1. Anything
+// else is its own publisher with a single message.
+static std::pair<std::string, uint64_t> SplitMessage(const std::string& msg) {
+  auto pos = msg.rfind(':');
+  if (pos != std::string::npos && pos + 1 < msg.size()) {
+    char* end = nullptr;
+    uint64_t seq = std::strtoull(msg.c_str() + pos + 1, &end, 10);
+    if (*end == '\0' && seq > 0) return {msg.substr(0, pos), seq};
+  }
+  return {msg, 1};
+}
+
+bool RepresentativeRelay::MarkRelayed(const std::string& msg) {
+  auto id = SplitMessage(msg);
+  auto& mark = relayed_[id.first];
+  if (id.second <= mark.contiguous || !mark.above.insert(id.second).second)
+    return false;
+  while (!mark.above.empty() && *mark.above.begin() == mark.contiguous + 1) {
+    mark.above.erase(mark.above.begin());
+    ++mark.contiguous;
+  }
+  return true;
+}
+
+bool RepresentativeRelay::IsRelayed(const std::string& msg) const {
+  auto id = SplitMessage(msg);
+  auto it = relayed_.find(id.first);
+  return it != relayed_.end() && (id.second <= it->second.contiguous ||
+                                  it->second.above.count(id.second) > 0);
+}
+
+void RepresentativeRelay::MemberMessage(std::string index,
+                                        const std::string& msg,
+                                        bool is_local) {
+  if (IsRelayed(msg)) return;
+  std::size_t i = std::stoul(index);
+  if (i == representative_) {
+    RelayUp(msg);
+    return;
+  }
+  auto& members = unrelayed_[msg];
+  members.resize(members_.size());
+  members[i] = true;
+}
+
+void RepresentativeRelay::MemberViewChange(
+    std::string index, const ::ndn::vsync::ViewID& vid,
+    const ::ndn::vsync::ViewInfo& vinfo, bool is_leader) {
+  std::size_t i = std::stoul(index);
+  if (!is_leader || i == representative_) return;
+  NS_LOG_INFO("representative of view " << vid << " is now member " << i);
+  representative_ = i;
+  ++changes_;
+
+  std::vector<std::string> backfill;
+  for (const auto& entry : unrelayed_)
+    if (i < entry.second.size() && entry.second[i])
+      backfill.push_back(entry.first);
+  for (const auto& msg : backfill) RelayUp(msg);
+}
+
+void RepresentativeRelay::GatewayMessage(const std::string& msg,
+                                         bool is_local) {
+  if (is_local || members_.empty() || !MarkRelayed(msg)) return;
+  down_.push_back(msg);
+  if (down_.size() == 1)
+    Simulator::Schedule(window_, &RepresentativeRelay::FlushDown, this);
+}
+
+void RepresentativeRelay::RelayUp(const std::string& msg) {
+  MarkRelayed(msg);
+  unrelayed_.erase(msg);
+  up_.push_back(msg);
+  if (up_.size() == 1)
+    Simulator::Schedule(window_, &RepresentativeRelay::FlushUp, this);
+}
+
+void RepresentativeRelay::FlushUp() {
+  relayed_up_ += up_.size();
+  std::vector<std::string> msgs;
+  msgs.swap(up_);
+  transfer_bytes_ += TransferBytes(msgs);
+  Simulator::Schedule(delay_, &RepresentativeRelay::DeliverUp, this, msgs);
+}
+
+void RepresentativeRelay::FlushDown() {
+  relayed_down_ += down_.size();
+  std::vector<std::string> msgs;
+  msgs.swap(down_);
+  transfer_bytes_ += TransferBytes(msgs);
+  Simulator::Schedule(delay_, &RepresentativeRelay::DeliverDown, this, msgs);
+}
+
+void RepresentativeRelay::DeliverUp(std::vector<std::string> msgs) {
+  gateway_->Relay(msgs);
+}
+
+// Goes to whoever represents the subgroup when the batch arrives.
+void RepresentativeRelay::DeliverDown(std::vector<std::string> msgs) {
+  members_[representative_]->Relay(msgs);
+}
+
+uint64_t RepresentativeRelay::TransferBytes(
+    const std::vector<std::string>& msgs) {
+  std::string content;
+  for (const auto& msg : msgs) content += msg + '\n';
+  ::ndn::Data data(::ndn::Name("/relay").appendNumber(++transfers_));
+  data.setContent(reinterpret_cast<const uint8_t*>(content.data()),
+                  content.size());
+  StackHelper::getKeyChain().sign(data,
+                                  ::ndn::security::signingWithSha256());
+  return static_cast<uint64_t>(hops_) * data.wireEncode().size();
+}
+
+}  // namespace vsync
+}  // namespace ndn
+}  // namespace ns3
@@ -0,0 +1,113 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#ifndef REPRESENTATIVE_RELAY_HPP_
+#define REPRESENTATIVE_RELAY_HPP_
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "ns3/nstime.h"
+
+#include "simple-app.hpp"
+
+namespace ns3 {
+namespace ndn {
+namespace vsync {
+
+// Joins one subgroup of a two-level sync group to the level above.
+//
+// Every subgroup syncs on its own, with a view of its members only, and one
+// gateway per subgroup syncs with the gateways of the other subgroups. The
+// relay hands the messages the subgroup's representative delivers to its
+// gateway, and the messages the gateway receives from other subgroups to the
+// representative. Messages crossing in one direction within |window| of the
+// first are published as one data item, so the upper level carries one
+// summary of the subgroup's activity per window. Each message crosses a
+// level once.
+//
+// The representative is the member that leads the subgroup's view, so it is
+// elected by the sync protocol and follows view changes; until a leader is
+// reported it is the first member. A new representative relays up what it
+// delivered before it took over and was not relayed yet.
+//
+// The gateway stands for the representative's interface to the upper level.
+// The transfer between them is modeled, not simulated: a batch arrives
+// |delay| after its window closes and costs the wire size of one signed Data
+// carrying it on each of |hops| links, which GetTransferBytes() reports.
+class RepresentativeRelay {
+ public:
+  RepresentativeRelay(Ptr<SimpleNodeApp> gateway, Time window, Time delay,
+                      uint32_t hops);
+
+  void AddMember(Ptr<SimpleNodeApp> member);
+
+  uint64_t GetRelayedUp() const { return relayed_up_; }
+
+  uint64_t GetRelayedDown() const { return relayed_down_; }
+
+  uint64_t GetRepresentativeChanges() const { return changes_; }
+
+  uint64_t GetTransferBytes() const { return transfer_bytes_; }
+
+ private:
+  // Sequence numbers of one publisher's messages: all up to |contiguous|,
+  // and those above it.
+  struct Watermark {
+    uint64_t contiguous = 0;
+    std::set<uint64_t> above;
+  };
+
+  // Records |msg| as handed across; returns false if it already was.
+  bool MarkRelayed(const std::string& msg);
+
+  bool IsRelayed(const std::string& msg) const;
+
+  void MemberMessage(std::string index, const std::string& msg,
+                     bool is_local);
+
+  void MemberViewChange(std::string index, const ::ndn::vsync::ViewID& vid,
+                        const ::ndn::vsync::ViewInfo& vinfo, bool is_leader);
+
+  void GatewayMessage(const std::string& msg, bool is_local);
+
+  void RelayUp(const std::string& msg);
+
+  void FlushUp();
+
+  void FlushDown();
+
+  void DeliverUp(std::vector<std::string> msgs);
+
+  void DeliverDown(std::vector<std::string> msgs);
+
+  // Bytes of one transfer of |msgs| over all hops.
+  uint64_t TransferBytes(const std::vector<std::string>& msgs);
+
+  Ptr<SimpleNodeApp> gateway_;
+  Time window_;
+  Time delay_;
+  uint32_t hops_;
+  std::vector<Ptr<SimpleNodeApp>> members_;
+  std::size_t representative_ = 0;
+  // Messages already handed across, in either direction, by publisher.
+  std::map<std::string, Watermark> relayed_;
+  // Members that delivered each message of the subgroup not relayed up yet.
+  std::map<std::string, std::vector<bool>> unrelayed_;
+  std::vector<std::string> up_;
+  std::vector<std::string> down_;
+
+  uint64_t relayed_up_ = 0;
+  uint64_t relayed_down_ = 0;
+  uint64_t changes_ = 0;
+  uint64_t transfers_ = 0;
+  uint64_t transfer_bytes_ = 0;
+};
+
+}  // namespace vsync
+}  // namespace ndn
+}  // namespace ns3
+
+#endif  // REPRESENTATIVE_RELAY_HPP_
@@ -0,0 +1,84 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#ifndef RNG_STREAM_HPP_
+#define RNG_STREAM_HPP_
+
+#include <array>
+#include <cstdint>
+
+namespace ndn {
+namespace vsync {
+namespace app {
+
+// Independent random streams for sync nodes, built on the Philox4x32-10
+// counter-based generator (Salmon et al., "Parallel Random Numbers: As Easy
+// as 1, 2, 3", SC'11).
+//
+// A stream is identified by (seed, run, node index, purpose). The key is
+// taken from the seed and run, and the node index and purpose occupy the
+// upper half of the counter. Every draw is therefore a pure function of that
+// identity and the draw number: runs are reproducible, distinct nodes and
+// purposes never share a sequence, and adding or removing nodes leaves the
+// streams of the others untouched.
+//
+// Satisfies UniformRandomBitGenerator, so it plugs into <random>
+// distributions in place of std::mt19937.
+class RngStream {
+ public:
+  using result_type = uint32_t;
+
+  enum Purpose : uint32_t {
+    kPublishTiming = 1,
+    kPayloadSize = 2,
+    kProtocolJitter = 3,
+  };
+
+  RngStream(uint32_t seed, uint64_t run, uint32_t node_index, Purpose purpose)
+      : key_{{static_cast<uint32_t>(run),
+               static_cast<uint32_t>(run >> 32) ^ seed}},
+        counter_{{0, 0, node_index, purpose}} {}
+
+  static constexpr result_type min() { return 0; }
+
+  static constexpr result_type max() { return 0xFFFFFFFF; }
+
+  result_type operator()() {
+    if (next_ == 4) {
+      block_ = Philox(counter_, key_);
+      if (++counter_[0] == 0) ++counter_[1];
+      next_ = 0;
+    }
+    return block_[next_++];
+  }
+
+  using Block = std::array<uint32_t, 4>;
+  using Key = std::array<uint32_t, 2>;
+
+  static Block Philox(Block ctr, Key key) {
+    for (int round = 0; round < 10; ++round) {
+      if (round > 0) {
+        key[0] += 0x9E3779B9;
+        key[1] += 0xBB67AE85;
+      }
+      uint64_t p0 = static_cast<uint64_t>(0xD2511F53) * ctr[0];
+      uint64_t p1 = static_cast<uint64_t>(0xCD9E8D57) * ctr[2];
+      ctr = {{static_cast<uint32_t>(p1 >> 32) ^ ctr[1] ^ key[0],
+              static_cast<uint32_t>(p1),
+              static_cast<uint32_t>(p0 >> 32) ^ ctr[3] ^ key[1],
+              static_cast<uint32_t>(p0)}};
+    }
+    return ctr;
+  }
+
+ private:
+  Key key_;
+  Block counter_;
+  Block block_;
+  int next_ = 4;
+};
+
+}  // namespace app
+}  // namespace vsync
+}  // namespace ndn
+
+#endif  // RNG_STREAM_HPP_
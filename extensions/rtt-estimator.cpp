@@ -0,0 +1,177 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#include "rtt-estimator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <iterator>
+
+#include "ns3/callback.h"
+#include "ns3/log.h"
+#include "ns3/names.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+
+#include "ns3/ndnSIM/model/ndn-l3-protocol.hpp"
+
+#include "node.hpp"
+
+NS_LOG_COMPONENT_DEFINE("ns3.ndn.vsync.RttEstimator");
+
+namespace ns3 {
+namespace ndn {
+namespace vsync {
+
+// Seconds between sweeps of unanswered interests.
+static const double kExpiryPeriod = 1.0;
+// An app retransmits a fetch when its interest times out, so a fetch is
+// kept for twice the lifetime of its last interest to see the retry.
+static const double kFetchLifetimes = 2.0;
+
+RttEstimator::RttEstimator(time::milliseconds sync_lifetime,
+                           time::milliseconds data_lifetime,
+                           time::milliseconds floor)
+    : sync_max_(sync_lifetime),
+      data_max_(data_lifetime),
+      floor_(floor),
+      sync_lifetime_(sync_lifetime),
+      data_lifetime_(data_lifetime) {}
+
+void RttEstimator::Install(const NodeContainer& nodes) {
+  for (auto node = nodes.Begin(); node != nodes.End(); ++node) {
+    Ptr<L3Protocol> l3 = (*node)->GetObject<L3Protocol>();
+    if (l3 == nullptr) continue;
+    std::string name = Names::FindName(*node);
+    if (name.empty()) name = std::to_string((*node)->GetId());
+    l3->TraceConnect("InInterests", name,
+                     MakeCallback(&RttEstimator::InInterests, this));
+    l3->TraceConnect("OutInterests", name,
+                     MakeCallback(&RttEstimator::OutInterests, this));
+    l3->TraceConnect("InData", name,
+                     MakeCallback(&RttEstimator::InData, this));
+  }
+}
+
+void RttEstimator::InInterests(std::string node, const Interest& interest,
+                               const nfd::Face& face) {
+  if (face.getScope() != ::ndn::nfd::FACE_SCOPE_LOCAL) return;
+  if (::ndn::vsync::kSyncPrefix.isPrefixOf(interest.getName())) return;
+
+  double now = Simulator::Now().GetSeconds();
+  Expire(now);
+  auto& fetch = fetches_[{node, interest.getName().toUri()}];
+  if (fetch.sends++ == 0)
+    fetch.first = now;
+  else
+    ++retransmissions_;
+  fetch.expires = now + kFetchLifetimes *
+                            interest.getInterestLifetime().count() / 1000.0;
+}
+
+void RttEstimator::OutInterests(std::string node, const Interest& interest,
+                                const nfd::Face& face) {
+  if (face.getScope() == ::ndn::nfd::FACE_SCOPE_LOCAL) return;
+  if (::ndn::vsync::kSyncPrefix.isPrefixOf(interest.getName())) return;
+
+  double now = Simulator::Now().GetSeconds();
+  Expire(now);
+  auto& out =
+      outstanding_[std::make_tuple(node, face.getId(),
+                                   interest.getName().toUri())];
+  out.sent = now;
+  out.expires = now + interest.getInterestLifetime().count() / 1000.0;
+  ++out.sends;
+}
+
+void RttEstimator::InData(std::string node, const Data& data,
+                          const nfd::Face& face) {
+  if (face.getScope() == ::ndn::nfd::FACE_SCOPE_LOCAL) return;
+  double now = Simulator::Now().GetSeconds();
+  const auto& name = data.getName();
+  auto uri = name.toUri();
+
+  auto out = outstanding_.find(std::make_tuple(node, face.getId(), uri));
+  if (out != outstanding_.end()) {
+    if (out->second.sends == 1)
+      AddSample(std::make_tuple(node, face.getId(), name.getPrefix(1).toUri()),
+                now - out->second.sent);
+    outstanding_.erase(out);
+  }
+
+  auto fetch = fetches_.find({node, uri});
+  if (fetch != fetches_.end()) {
+    if (fetch->second.sends > 1) {
+      double d = now - fetch->second.first;
+      ++recovered_;
+      recovery_delay_sum_ += d;
+      max_recovery_delay_ = std::max(max_recovery_delay_, d);
+    }
+    fetches_.erase(fetch);
+  }
+}
+
+void RttEstimator::AddSample(const EstimateKey& key, double rtt) {
+  auto& e = estimates_[key];
+  if (!e.valid) {
+    e.srtt = rtt;
+    e.rttvar = rtt / 2;
+    e.valid = true;
+  } else {
+    e.rttvar = 0.75 * e.rttvar + 0.25 * std::abs(e.srtt - rtt);
+    e.srtt = 0.875 * e.srtt + 0.125 * rtt;
+  }
+  UpdateLifetimes();
+}
+
+void RttEstimator::Expire(double now) {
+  if (now < next_expiry_) return;
+  next_expiry_ = now + kExpiryPeriod;
+  for (auto it = outstanding_.begin(); it != outstanding_.end();)
+    it = it->second.expires < now ? outstanding_.erase(it) : std::next(it);
+  for (auto it = fetches_.begin(); it != fetches_.end();)
+    it = it->second.expires < now ? fetches_.erase(it) : std::next(it);
+}
+
+void RttEstimator::UpdateLifetimes() {
+  double rto = 0.0;
+  for (const auto& e : estimates_)
+    rto = std::max(rto, e.second.srtt + 4 * e.second.rttvar);
+  auto ms = time::milliseconds(static_cast<int64_t>(std::ceil(rto * 1000)));
+  auto lifetime = [&](time::milliseconds max) {
+    return estimates_.empty() ? max : std::min(max, std::max(floor_, ms));
+  };
+
+  auto sync_lifetime = lifetime(sync_max_);
+  auto data_lifetime = lifetime(data_max_);
+  if (sync_lifetime == sync_lifetime_ && data_lifetime == data_lifetime_)
+    return;
+
+  sync_lifetime_ = sync_lifetime;
+  data_lifetime_ = data_lifetime;
+  if (!adaptive_) return;
+  NS_LOG_INFO("sync_lifetime=" << sync_lifetime_
+                               << ", data_lifetime=" << data_lifetime_);
+  ::ndn::vsync::SetInterestLifetime(sync_lifetime_, data_lifetime_);
+}
+
+void RttEstimator::Report() {
+  std::cout << "Number of data interest retransmissions is: "
+            << retransmissions_ << std::endl;
+  std::cout << "Number of fetches recovered by retransmission is: "
+            << recovered_ << std::endl;
+  std::cout << "Average loss recovery delay is: "
+            << (recovered_ > 0 ? recovery_delay_sum_ / recovered_ : 0.0)
+            << " seconds." << std::endl;
+  std::cout << "Max loss recovery delay is: " << max_recovery_delay_
+            << " seconds." << std::endl;
+  std::string kind = adaptive_ ? "Final" : "RTT-based";
+  std::cout << kind << " sync interest lifetime is: " << sync_lifetime_.count()
+            << " ms." << std::endl;
+  std::cout << kind << " data interest lifetime is: " << data_lifetime_.count()
+            << " ms." << std::endl;
+}
+
+}  // namespace vsync
+}  // namespace ndn
+}  // namespace ns3
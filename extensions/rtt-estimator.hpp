@@ -0,0 +1,118 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#ifndef RTT_ESTIMATOR_HPP_
+#define RTT_ESTIMATOR_HPP_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <tuple>
+
+#include "ns3/node-container.h"
+#include "ns3/ndnSIM/NFD/daemon/face/face.hpp"
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+namespace ns3 {
+namespace ndn {
+namespace vsync {
+
+// Sets the sync and data interest lifetimes from measured round-trip times
+// instead of fixed multiples of the link delay.
+//
+// Every data interest a node sends upstream is matched with the Data that
+// comes back on the same face, giving one RTT sample for that neighbor and
+// publisher (the first name component). Samples of interests sent more than
+// once are dropped (Karn's algorithm). Each (node, face, publisher) keeps
+// SRTT and RTTVAR as in RFC 6298, with RTO = SRTT + 4 * RTTVAR.
+//
+// Sync interests are multicast and mostly go unanswered, so they are not
+// timed; they cross the same faces as the data fetches, and their lifetime
+// follows the same RTO. Interests that get no Data are forgotten once their
+// lifetime has passed.
+//
+// The library only has process-wide lifetimes, so both lifetimes follow the
+// largest RTO among the estimators, which keeps the slowest path from
+// retransmitting spuriously. Each never exceeds the static lifetime the
+// scenario configured and never drops below |floor|.
+//
+// The estimator also counts data interest retransmissions by the apps and
+// the time from the first fetch to the Data for fetches that needed them.
+class RttEstimator {
+ public:
+  RttEstimator(time::milliseconds sync_lifetime,
+               time::milliseconds data_lifetime, time::milliseconds floor);
+
+  void Install(const NodeContainer& nodes);
+
+  // Without this the estimator only measures, which gives the
+  // retransmission statistics of the static lifetimes for comparison.
+  void EnableAdaptiveLifetimes() { adaptive_ = true; }
+
+  // Prints retransmission and loss recovery statistics and the final
+  // lifetimes.
+  void Report();
+
+ private:
+  struct Estimate {
+    double srtt = 0.0;
+    double rttvar = 0.0;
+    bool valid = false;
+  };
+
+  struct Outstanding {
+    double sent = 0.0;
+    double expires = 0.0;
+    int sends = 0;
+  };
+
+  struct Fetch {
+    double first = 0.0;
+    double expires = 0.0;
+    int sends = 0;
+  };
+
+  // Node, face and publisher (or full name for outstanding interests).
+  using EstimateKey = std::tuple<std::string, nfd::FaceId, std::string>;
+
+  void InInterests(std::string node, const Interest& interest,
+                   const nfd::Face& face);
+
+  void OutInterests(std::string node, const Interest& interest,
+                    const nfd::Face& face);
+
+  void InData(std::string node, const Data& data, const nfd::Face& face);
+
+  void AddSample(const EstimateKey& key, double rtt);
+
+  // Drops the interests and fetches whose lifetime has passed without Data.
+  void Expire(double now);
+
+  void UpdateLifetimes();
+
+ private:
+  time::milliseconds sync_max_;
+  time::milliseconds data_max_;
+  time::milliseconds floor_;
+  bool adaptive_ = false;
+
+  std::map<EstimateKey, Estimate> estimates_;
+  // Data interests sent upstream and not answered yet, by node, face and
+  // name.
+  std::map<EstimateKey, Outstanding> outstanding_;
+  // Data fetches issued by the apps and not answered yet, by node and name.
+  std::map<std::pair<std::string, std::string>, Fetch> fetches_;
+  double next_expiry_ = 0.0;
+
+  uint64_t retransmissions_ = 0;
+  uint64_t recovered_ = 0;
+  double recovery_delay_sum_ = 0.0;
+  double max_recovery_delay_ = 0.0;
+  time::milliseconds sync_lifetime_;
+  time::milliseconds data_lifetime_;
+};
+
+}  // namespace vsync
+}  // namespace ndn
+}  // namespace ns3
+
+#endif  // RTT_ESTIMATOR_HPP_
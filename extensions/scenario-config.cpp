@@ -0,0 +1,128 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#include "scenario-config.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace ns3 {
+namespace ndn {
+namespace vsync {
+
+static std::string Trim(const std::string& s) {
+  auto begin = s.find_first_not_of(" \t\r");
+  if (begin == std::string::npos) return "";
+  auto end = s.find_last_not_of(" \t\r");
+  return s.substr(begin, end - begin + 1);
+}
+
+void ScenarioConfig::Load(const std::string& file) {
+  std::ifstream is(file);
+  if (!is) throw std::invalid_argument("Cannot open config file " + file);
+
+  std::string line;
+  int line_number = 0;
+  while (std::getline(is, line)) {
+    ++line_number;
+    ParseLine(line, file + ":" + std::to_string(line_number));
+  }
+}
+
+void ScenarioConfig::ApplyOverrides(const std::string& overrides) {
+  std::istringstream is(overrides);
+  std::string item;
+  while (std::getline(is, item, ';')) ParseLine(item, "override");
+}
+
+void ScenarioConfig::ParseLine(const std::string& line,
+                               const std::string& where) {
+  std::string s = Trim(line);
+  if (s.empty() || s[0] == '#') return;
+
+  auto pos = s.find('=');
+  if (pos == std::string::npos)
+    throw std::invalid_argument(where + ": expected \"Key = value\"");
+
+  std::string key = Trim(s.substr(0, pos));
+  if (key.empty()) throw std::invalid_argument(where + ": empty key");
+  values_[key] = Trim(s.substr(pos + 1));
+}
+
+std::string ScenarioConfig::GetString(const std::string& key,
+                                      const std::string& default_value) const {
+  used_.insert(key);
+  auto it = values_.find(key);
+  return it == values_.end() ? default_value : it->second;
+}
+
+int ScenarioConfig::GetInt(const std::string& key, int default_value) const {
+  used_.insert(key);
+  auto it = values_.find(key);
+  if (it == values_.end()) return default_value;
+  try {
+    return std::stoi(it->second);
+  } catch (const std::exception&) {
+    throw std::invalid_argument("Invalid integer for " + key + ": " +
+                                it->second);
+  }
+}
+
+double ScenarioConfig::GetDouble(const std::string& key,
+                                 double default_value) const {
+  used_.insert(key);
+  auto it = values_.find(key);
+  if (it == values_.end()) return default_value;
+  try {
+    return std::stod(it->second);
+  } catch (const std::exception&) {
+    throw std::invalid_argument("Invalid number for " + key + ": " +
+                                it->second);
+  }
+}
+
+bool ScenarioConfig::GetBool(const std::string& key,
+                             bool default_value) const {
+  used_.insert(key);
+  auto it = values_.find(key);
+  if (it == values_.end()) return default_value;
+  const std::string& v = it->second;
+  if (v == "true" || v == "1" || v == "yes") return true;
+  if (v == "false" || v == "0" || v == "no") return false;
+  throw std::invalid_argument("Invalid boolean for " + key + ": " + v);
+}
+
+std::vector<std::string> ScenarioConfig::GetList(
+    const std::string& key) const {
+  std::vector<std::string> result;
+  std::istringstream is(GetString(key, ""));
+  std::string item;
+  while (std::getline(is, item, ',')) {
+    item = Trim(item);
+    if (!item.empty()) result.push_back(item);
+  }
+  return result;
+}
+
+std::map<std::string, std::string> ScenarioConfig::GetWithPrefix(
+    const std::string& prefix) const {
+  std::map<std::string, std::string> result;
+  for (auto it = values_.lower_bound(prefix);
+       it != values_.end() && it->first.compare(0, prefix.size(), prefix) == 0;
+       ++it) {
+    used_.insert(it->first);
+    result[it->first.substr(prefix.size())] = it->second;
+  }
+  return result;
+}
+
+std::vector<std::string> ScenarioConfig::GetUnusedKeys() const {
+  std::vector<std::string> result;
+  for (const auto& kv : values_)
+    if (used_.count(kv.first) == 0) result.push_back(kv.first);
+  return result;
+}
+
+}  // namespace vsync
+}  // namespace ndn
+}  // namespace ns3
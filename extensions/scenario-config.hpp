@@ -0,0 +1,67 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#ifndef SCENARIO_CONFIG_HPP_
+#define SCENARIO_CONFIG_HPP_
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+namespace vsync {
+
+// Flat key/value description of a simulation, read by the scenario engine.
+//
+// The file format follows the topology files: one "Key = value" pair per
+// line, empty lines and lines starting with '#' are ignored. Overrides given
+// on the command line as "Key=value;Key=value" replace values from the file,
+// so a sweep can reuse one config and one binary.
+//
+// Malformed input throws std::invalid_argument. The getters remember which
+// keys they were asked for, so that a misspelled key, which would otherwise
+// silently leave the default in place, can be reported by GetUnusedKeys().
+class ScenarioConfig {
+ public:
+  void Load(const std::string& file);
+
+  void ApplyOverrides(const std::string& overrides);
+
+  void Set(const std::string& key, const std::string& value) {
+    values_[key] = value;
+  }
+
+  bool Has(const std::string& key) const { return values_.count(key) > 0; }
+
+  std::string GetString(const std::string& key,
+                        const std::string& default_value) const;
+
+  int GetInt(const std::string& key, int default_value) const;
+
+  double GetDouble(const std::string& key, double default_value) const;
+
+  bool GetBool(const std::string& key, bool default_value) const;
+
+  // Comma-separated list; empty entries are skipped.
+  std::vector<std::string> GetList(const std::string& key) const;
+
+  // All keys of the form "<prefix><name>", keyed by <name>.
+  std::map<std::string, std::string> GetWithPrefix(
+      const std::string& prefix) const;
+
+  // Keys that are set but were never read by any of the getters above.
+  std::vector<std::string> GetUnusedKeys() const;
+
+ private:
+  void ParseLine(const std::string& line, const std::string& where);
+
+  std::map<std::string, std::string> values_;
+  mutable std::set<std::string> used_;
+};
+
+}  // namespace vsync
+}  // namespace ndn
+}  // namespace ns3
+
+#endif  // SCENARIO_CONFIG_HPP_
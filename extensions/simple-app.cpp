@@ -2,6 +2,8 @@
 
 #include "simple-app.hpp"
 
+#include "ns3/rng-seed-manager.h"
+
 NS_LOG_COMPONENT_DEFINE("ns3.ndn.vsync.SimpleNodeApp");
 
 namespace ns3 {
@@ -11,9 +13,19 @@ namespace vsync {
 NS_OBJECT_ENSURE_REGISTERED(SimpleNodeApp);
 
 void SimpleNodeApp::StartApplication() {
-  NS_LOG_INFO("NodeID: " << node_id_ << " Seed: " << seed_);
+  NS_LOG_INFO("NodeID: " << node_id_ << " NodeIndex: " << node_index_);
   node_.reset(new ::ndn::vsync::app::SimpleNode(
-      node_id_, ndn::StackHelper::getKeyChain(), seed_, data_rate_));
+      node_id_, ndn::StackHelper::getKeyChain(), RngSeedManager::GetSeed(),
+      RngSeedManager::GetRun(), node_index_, data_rate_));
+  node_->SetRetentionPolicy(::ndn::vsync::app::RetentionPolicy::Parse(
+      retention_limit_, retention_max_, retention_eviction_));
+  if (catch_up_)
+    node_->EnableCatchUp(catch_up_threshold_, catch_up_max_window_);
+  if (snapshot_horizon_ > 0) {
+    node_->EnableSnapshots(snapshot_horizon_);
+    if (!bootstrap_peer_.empty())
+      node_->SetBootstrapPeer(bootstrap_peer_, snapshot_window_);
+  }
 
   if (!vinfo_proto_.empty()) {
     ::ndn::vsync::ViewInfo vinfo;
@@ -22,12 +34,38 @@ void SimpleNodeApp::StartApplication() {
     node_->SetViewInfo(vinfo);
   }
 
+  if (adaptive_heartbeat_)
+    node_->EnableAdaptiveHeartbeat(
+        ::ndn::time::milliseconds(heartbeat_min_.GetMilliSeconds()),
+        ::ndn::time::milliseconds(heartbeat_max_.GetMilliSeconds()));
+  node_->SetMaxDataCount(max_data_count_);
+  node_->SetCoalescing(
+      ::ndn::time::milliseconds(coalesce_window_.GetMilliSeconds()),
+      max_batch_);
+  node_->SetObjectMode(object_size_, segment_size_, pipeline_window_,
+                       segments_as_versions_);
+
   node_->ConnectVectorChangeTrace(
       std::bind(&SimpleNodeApp::TraceVectorChange, this, _1, _2));
   node_->ConnectViewChangeTrace(
       std::bind(&SimpleNodeApp::TraceViewChange, this, _1, _2, _3));
   node_->ConnectDataEventTrace(
       std::bind(&SimpleNodeApp::TraceDataEvent, this, _1, _2));
+  node_->ConnectMessageEventTrace(
+      std::bind(&SimpleNodeApp::TraceMessageEvent, this, _1, _2));
+  node_->ConnectHeartbeatTrace(
+      std::bind(&SimpleNodeApp::TraceHeartbeat, this, _1));
+  node_->ConnectPublishingDoneTrace(
+      std::bind(&SimpleNodeApp::TracePublishingDone, this));
+  node_->ConnectObjectEventTrace(
+      std::bind(&SimpleNodeApp::TraceObjectEvent, this, _1, _2, _3));
+  node_->ConnectCatchUpTrace(
+      std::bind(&SimpleNodeApp::TraceCatchUp, this, _1, _2, _3));
+  node_->ConnectSnapshotTrace(
+      std::bind(&SimpleNodeApp::TraceSnapshot, this, _1, _2));
+  node_->ConnectDataStoreTrace(
+      std::bind(&SimpleNodeApp::TraceDataStore, this, _1, _2));
+  node_->ConnectFetchTrace(std::bind(&SimpleNodeApp::TraceFetch, this, _1));
   node_->Start();
 }
 
@@ -9,6 +9,7 @@
 #include "ns3/boolean.h"
 #include "ns3/double.h"
 #include "ns3/ndnSIM/helper/ndn-stack-helper.hpp"
+#include "ns3/nstime.h"
 #include "ns3/string.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/traced-callback.h"
@@ -28,6 +29,15 @@ class SimpleNodeApp : public Application {
                                           const ::ndn::vsync::ViewInfo&, bool);
   typedef void (*DataEventTraceCallback)(std::shared_ptr<const ndn::Data>,
                                          bool);
+  typedef void (*MessageEventTraceCallback)(const std::string&, bool);
+  typedef void (*HeartbeatTraceCallback)(Time);
+  typedef void (*PublishingDoneTraceCallback)();
+  typedef void (*ObjectEventTraceCallback)(const std::string&, std::size_t,
+                                           bool);
+  typedef void (*CatchUpTraceCallback)(const std::string&, uint64_t, Time);
+  typedef void (*SnapshotTraceCallback)(std::size_t, Time);
+  typedef void (*DataStoreTraceCallback)(std::size_t, std::size_t);
+  typedef void (*FetchTraceCallback)(bool);
 
   static TypeId GetTypeId() {
     static TypeId tid =
@@ -43,8 +53,11 @@ class SimpleNodeApp : public Application {
                           MakeStringAccessor(&SimpleNodeApp::vinfo_proto_),
                           MakeStringChecker())
             .AddAttribute(
-                "RandomSeed", "Seed used for the random number generator.",
-                UintegerValue(0), MakeUintegerAccessor(&SimpleNodeApp::seed_),
+                "NodeIndex",
+                "Index of the node in the group, selecting its random streams "
+                "within the run given by RngSeed and RngRun.",
+                UintegerValue(0),
+                MakeUintegerAccessor(&SimpleNodeApp::node_index_),
                 MakeUintegerChecker<uint32_t>())
             .AddAttribute(
                 "DataRate",
@@ -52,6 +65,126 @@ class SimpleNodeApp : public Application {
                 DoubleValue(1.0),
                 MakeDoubleAccessor(&SimpleNodeApp::data_rate_),
                 MakeDoubleChecker<double>())
+            .AddAttribute("MaxDataCount",
+                          "Number of messages the node generates in total "
+                          "(0 for a node that only relays).",
+                          UintegerValue(100),
+                          MakeUintegerAccessor(&SimpleNodeApp::max_data_count_),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute(
+                "AdaptiveHeartbeat",
+                "If set, the heartbeat interval backs off while the group is "
+                "quiet and tightens once any adaptive member publishes or "
+                "receives data. The interval is shared by the whole group.",
+                BooleanValue(false),
+                MakeBooleanAccessor(&SimpleNodeApp::adaptive_heartbeat_),
+                MakeBooleanChecker())
+            .AddAttribute("HeartbeatMin",
+                          "Shortest adaptive heartbeat interval.",
+                          TimeValue(Seconds(1.0)),
+                          MakeTimeAccessor(&SimpleNodeApp::heartbeat_min_),
+                          MakeTimeChecker())
+            .AddAttribute("HeartbeatMax",
+                          "Longest adaptive heartbeat interval.",
+                          TimeValue(Seconds(8.0)),
+                          MakeTimeAccessor(&SimpleNodeApp::heartbeat_max_),
+                          MakeTimeChecker())
+            .AddAttribute(
+                "CoalesceWindow",
+                "Messages generated within this window are published as one "
+                "data item (0 publishes every message on its own).",
+                TimeValue(Seconds(0.0)),
+                MakeTimeAccessor(&SimpleNodeApp::coalesce_window_),
+                MakeTimeChecker())
+            .AddAttribute("MaxBatchSize",
+                          "Maximum number of messages in one data item.",
+                          UintegerValue(16),
+                          MakeUintegerAccessor(&SimpleNodeApp::max_batch_),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute(
+                "ObjectSize",
+                "Size in bytes of the object each message stands for (0 "
+                "publishes plain messages).",
+                UintegerValue(0),
+                MakeUintegerAccessor(&SimpleNodeApp::object_size_),
+                MakeUintegerChecker<uint32_t>())
+            .AddAttribute("SegmentSize", "Size in bytes of an object segment.",
+                          UintegerValue(1024),
+                          MakeUintegerAccessor(&SimpleNodeApp::segment_size_),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute(
+                "PipelineWindow",
+                "Maximum number of segment interests in flight per object.",
+                UintegerValue(8),
+                MakeUintegerAccessor(&SimpleNodeApp::pipeline_window_),
+                MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute(
+                "SegmentsAsVersions",
+                "If set, every object segment is published as a sync update "
+                "of its own instead of behind a manifest.",
+                BooleanValue(false),
+                MakeBooleanAccessor(&SimpleNodeApp::segments_as_versions_),
+                MakeBooleanChecker())
+            .AddAttribute(
+                "CatchUpEnabled",
+                "If set, the node prefetches missing ranges with an AIMD "
+                "interest window once it falls far behind a member.",
+                BooleanValue(false),
+                MakeBooleanAccessor(&SimpleNodeApp::catch_up_),
+                MakeBooleanChecker())
+            .AddAttribute(
+                "CatchUpThreshold",
+                "Number of items behind a member that starts a catch-up.",
+                UintegerValue(4),
+                MakeUintegerAccessor(&SimpleNodeApp::catch_up_threshold_),
+                MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute(
+                "CatchUpMaxWindow",
+                "Maximum number of catch-up interests in flight per member.",
+                UintegerValue(32),
+                MakeUintegerAccessor(&SimpleNodeApp::catch_up_max_window_),
+                MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute(
+                "SnapshotHorizon",
+                "Number of recent data items the node keeps and serves as a "
+                "snapshot to joiners (0 disables snapshots).",
+                UintegerValue(0),
+                MakeUintegerAccessor(&SimpleNodeApp::snapshot_horizon_),
+                MakeUintegerChecker<uint32_t>())
+            .AddAttribute(
+                "BootstrapPeer",
+                "Member to load a snapshot from before joining sync (empty "
+                "to join directly). Requires SnapshotHorizon.",
+                StringValue(""),
+                MakeStringAccessor(&SimpleNodeApp::bootstrap_peer_),
+                MakeStringChecker())
+            .AddAttribute(
+                "SnapshotWindow",
+                "Maximum number of snapshot segment interests in flight.",
+                UintegerValue(8),
+                MakeUintegerAccessor(&SimpleNodeApp::snapshot_window_),
+                MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute(
+                "RetentionLimit",
+                "What bounds the data store the node accounts: none (no "
+                "store), count, bytes or age.",
+                StringValue("none"),
+                MakeStringAccessor(&SimpleNodeApp::retention_limit_),
+                MakeStringChecker())
+            .AddAttribute(
+                "RetentionMax",
+                "Items, bytes or milliseconds the data store may hold, "
+                "depending on RetentionLimit; above 0 unless it is none.",
+                UintegerValue(0),
+                MakeUintegerAccessor(&SimpleNodeApp::retention_max_),
+                MakeUintegerChecker<uint64_t>())
+            .AddAttribute(
+                "RetentionEviction",
+                "Which item the data store drops first: lru, or window (the "
+                "oldest item of the publisher holding the most).",
+                StringValue("lru"),
+                MakeStringAccessor(&SimpleNodeApp::retention_eviction_),
+                MakeStringChecker())
             .AddTraceSource(
                 "VectorChange", "Vector change event from the sync node.",
                 MakeTraceSourceAccessor(&SimpleNodeApp::vector_change_trace_),
@@ -64,11 +197,61 @@ class SimpleNodeApp : public Application {
                 "DataEvent",
                 "Event of publishing or receiving new data in the sync node.",
                 MakeTraceSourceAccessor(&SimpleNodeApp::data_event_trace_),
-                "ns3::ndn::vsync::SimpleNodeApp::DataEventTraceCallback");
+                "ns3::ndn::vsync::SimpleNodeApp::DataEventTraceCallback")
+            .AddTraceSource(
+                "MessageEvent",
+                "Event of generating or receiving an application message.",
+                MakeTraceSourceAccessor(&SimpleNodeApp::message_event_trace_),
+                "ns3::ndn::vsync::SimpleNodeApp::MessageEventTraceCallback")
+            .AddTraceSource(
+                "Heartbeat",
+                "End of an adaptive heartbeat period, with its interval.",
+                MakeTraceSourceAccessor(&SimpleNodeApp::heartbeat_trace_),
+                "ns3::ndn::vsync::SimpleNodeApp::HeartbeatTraceCallback")
+            .AddTraceSource(
+                "PublishingDone",
+                "The node generated its last message, or started with none "
+                "to generate.",
+                MakeTraceSourceAccessor(&SimpleNodeApp::publishing_done_trace_),
+                "ns3::ndn::vsync::SimpleNodeApp::PublishingDoneTraceCallback")
+            .AddTraceSource(
+                "ObjectEvent",
+                "An object was published, or fully received at a receiver.",
+                MakeTraceSourceAccessor(&SimpleNodeApp::object_event_trace_),
+                "ns3::ndn::vsync::SimpleNodeApp::ObjectEventTraceCallback")
+            .AddTraceSource(
+                "CatchUp",
+                "A catch-up finished, with the member, its depth in items and "
+                "its recovery time.",
+                MakeTraceSourceAccessor(&SimpleNodeApp::catch_up_trace_),
+                "ns3::ndn::vsync::SimpleNodeApp::CatchUpTraceCallback")
+            .AddTraceSource(
+                "Snapshot",
+                "The node finished loading a snapshot, with the number of "
+                "items and the time it took.",
+                MakeTraceSourceAccessor(&SimpleNodeApp::snapshot_trace_),
+                "ns3::ndn::vsync::SimpleNodeApp::SnapshotTraceCallback")
+            .AddTraceSource(
+                "DataStore",
+                "The accounted data store changed, with its item count and "
+                "bytes. The sync node's own copies are not included.",
+                MakeTraceSourceAccessor(&SimpleNodeApp::data_store_trace_),
+                "ns3::ndn::vsync::SimpleNodeApp::DataStoreTraceCallback")
+            .AddTraceSource(
+                "Fetch",
+                "A member fetched an item of the node, with whether the data "
+                "store still retained it.",
+                MakeTraceSourceAccessor(&SimpleNodeApp::fetch_trace_),
+                "ns3::ndn::vsync::SimpleNodeApp::FetchTraceCallback");
 
     return tid;
   }
 
+  // See SimpleNode::Relay. Ignored while the application is not running.
+  void Relay(const std::vector<std::string>& msgs) {
+    if (node_) node_->Relay(msgs);
+  }
+
  protected:
   virtual void StartApplication();
 
@@ -88,11 +271,60 @@ class SimpleNodeApp : public Application {
     data_event_trace_(data, is_local);
   }
 
+  void TraceMessageEvent(const std::string& msg, bool is_local) {
+    message_event_trace_(msg, is_local);
+  }
+
+  void TraceHeartbeat(::ndn::time::milliseconds interval) {
+    heartbeat_trace_(MilliSeconds(interval.count()));
+  }
+
+  void TracePublishingDone() { publishing_done_trace_(); }
+
+  void TraceObjectEvent(const std::string& id, std::size_t bytes,
+                        bool is_local) {
+    object_event_trace_(id, bytes, is_local);
+  }
+
+  void TraceCatchUp(const ::ndn::Name& member, uint64_t depth,
+                    ::ndn::time::milliseconds recovery) {
+    catch_up_trace_(member.toUri(), depth, MilliSeconds(recovery.count()));
+  }
+
+  void TraceSnapshot(std::size_t items, ::ndn::time::milliseconds duration) {
+    snapshot_trace_(items, MilliSeconds(duration.count()));
+  }
+
+  void TraceDataStore(std::size_t items, std::size_t bytes) {
+    data_store_trace_(items, bytes);
+  }
+
+  void TraceFetch(bool retained) { fetch_trace_(retained); }
+
  private:
   std::unique_ptr<::ndn::vsync::app::SimpleNode> node_;
   std::string node_id_;
-  uint32_t seed_;
+  uint32_t node_index_;
   double data_rate_;
+  uint32_t max_data_count_;
+  bool adaptive_heartbeat_;
+  Time heartbeat_min_;
+  Time heartbeat_max_;
+  Time coalesce_window_;
+  uint32_t max_batch_;
+  uint32_t object_size_;
+  uint32_t segment_size_;
+  uint32_t pipeline_window_;
+  bool segments_as_versions_;
+  bool catch_up_;
+  uint32_t catch_up_threshold_;
+  uint32_t catch_up_max_window_;
+  uint32_t snapshot_horizon_;
+  std::string bootstrap_peer_;
+  uint32_t snapshot_window_;
+  std::string retention_limit_;
+  uint64_t retention_max_;
+  std::string retention_eviction_;
 
   std::string vinfo_proto_;
 
@@ -102,6 +334,14 @@ class SimpleNodeApp : public Application {
   TracedCallback<std::size_t, const ::ndn::vsync::VersionVector&>
       vector_change_trace_;
   TracedCallback<std::shared_ptr<const ndn::Data>, bool> data_event_trace_;
+  TracedCallback<const std::string&, bool> message_event_trace_;
+  TracedCallback<Time> heartbeat_trace_;
+  TracedCallback<> publishing_done_trace_;
+  TracedCallback<const std::string&, std::size_t, bool> object_event_trace_;
+  TracedCallback<const std::string&, uint64_t, Time> catch_up_trace_;
+  TracedCallback<std::size_t, Time> snapshot_trace_;
+  TracedCallback<std::size_t, std::size_t> data_store_trace_;
+  TracedCallback<bool> fetch_trace_;
 };
 
 }  // namespace vsync
@@ -7,6 +7,7 @@
 
 #include "ns3/application.h"
 #include "ns3/ndnSIM/helper/ndn-stack-helper.hpp"
+#include "ns3/nstime.h"
 #include "ns3/string.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/traced-callback.h"
@@ -37,9 +38,19 @@ class SimpleCOApp : public Application {
                           MakeStringAccessor(&SimpleCOApp::node_id_),
                           MakeStringChecker())
             .AddAttribute(
-                "RandomSeed", "Seed used for the random number generator.",
-                UintegerValue(0), MakeUintegerAccessor(&SimpleCOApp::seed_),
+                "NodeIndex",
+                "Index of the node in the group, selecting its random streams "
+                "within the run given by RngSeed and RngRun.",
+                UintegerValue(0),
+                MakeUintegerAccessor(&SimpleCOApp::node_index_),
                 MakeUintegerChecker<uint32_t>())
+            .AddAttribute(
+                "StartDelay",
+                "Time the node waits after starting before publishing its "
+                "first data, letting the view settle.",
+                TimeValue(Seconds(8.0)),
+                MakeTimeAccessor(&SimpleCOApp::start_delay_),
+                MakeTimeChecker())
             .AddTraceSource(
                 "VectorChange", "Vector change event from the sync node.",
                 MakeTraceSourceAccessor(&SimpleCOApp::vector_change_trace_),
@@ -79,7 +90,8 @@ class SimpleCOApp : public Application {
  private:
   std::unique_ptr<::ndn::vsync::app::SimpleCONode> node_;
   std::string node_id_;
-  uint32_t seed_;
+  uint32_t node_index_;
+  Time start_delay_;
 
   TracedCallback<const ::ndn::vsync::ViewID&, const ::ndn::vsync::ViewInfo&,
                  bool>
@@ -2,6 +2,8 @@
 
 #include "simple-fifo-app.hpp"
 
+#include "ns3/rng-seed-manager.h"
+
 NS_LOG_COMPONENT_DEFINE("ns3.ndn.vsync.SimpleFIFOApp");
 
 namespace ns3 {
@@ -11,16 +13,17 @@ namespace vsync {
 NS_OBJECT_ENSURE_REGISTERED(SimpleFIFOApp);
 
 void SimpleFIFOApp::StartApplication() {
-  NS_LOG_INFO("NodeID: " << node_id_ << " Seed: " << seed_);
+  NS_LOG_INFO("NodeID: " << node_id_ << " NodeIndex: " << node_index_);
   node_.reset(new ::ndn::vsync::app::SimpleFIFONode(
-      node_id_, ndn::StackHelper::getKeyChain(), seed_));
+      node_id_, ndn::StackHelper::getKeyChain(), RngSeedManager::GetSeed(),
+      RngSeedManager::GetRun(), node_index_));
   node_->ConnectVectorChangeTrace(
       std::bind(&SimpleFIFOApp::TraceVectorChange, this, _1, _2));
   node_->ConnectViewChangeTrace(
       std::bind(&SimpleFIFOApp::TraceViewChange, this, _1, _2, _3));
   node_->ConnectDataEventTrace(
       std::bind(&SimpleFIFOApp::TraceDataEvent, this, _1, _2));
-  node_->Start();
+  node_->Start(::ndn::time::milliseconds(start_delay_.GetMilliSeconds()));
 }
 
 }  // namespace vsync
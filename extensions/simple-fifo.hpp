@@ -7,6 +7,7 @@
 #include <random>
 
 #include "fifo.hpp"
+#include "rng-stream.hpp"
 
 namespace ndn {
 namespace vsync {
@@ -19,20 +20,25 @@ class SimpleFIFONode {
   using DataEventTraceCb =
       std::function<void(std::shared_ptr<const Data>, bool)>;
 
-  SimpleFIFONode(const Name& nid, KeyChain& keychain, uint32_t seed)
+  // |seed| and |run| identify the simulation run and |node_index| the node
+  // within it; together they select the node's random streams.
+  SimpleFIFONode(const Name& nid, KeyChain& keychain, uint32_t seed,
+                 uint64_t run, uint32_t node_index)
       : scheduler_(face_.getIoService()),
         key_chain_(keychain),
-        node_(face_, scheduler_, key_chain_, nid, seed),
-        rengine_(seed),
+        node_(face_, scheduler_, key_chain_, nid,
+              RngStream(seed, run, node_index, RngStream::kProtocolJitter)()),
+        rengine_(seed, run, node_index, RngStream::kPublishTiming),
         rdist_(500, 10000) {
     node_.ConnectFIFODataSignal(std::bind(&SimpleFIFONode::OnData, this, _1));
   }
 
-  void Start() {
-    // Wait for 8 seconds before publishing the first data packet.
-    // This allows the view change process to stablize.
-    scheduler_.scheduleEvent(time::milliseconds(8000 + rdist_(rengine_)),
-                             [this] { PublishData(); });
+  // Waits |start_delay| before publishing the first data packet, which
+  // allows the view change process to stabilize.
+  void Start(time::milliseconds start_delay) {
+    scheduler_.scheduleEvent(
+        start_delay + time::milliseconds(rdist_(rengine_)),
+        [this] { PublishData(); });
     face_.processEvents();
   }
 
@@ -66,7 +72,7 @@ class SimpleFIFONode {
   KeyChain& key_chain_;
   FIFONode node_;
 
-  std::mt19937 rengine_;
+  RngStream rengine_;
   std::uniform_int_distribution<> rdist_;
 
   util::Signal<SimpleFIFONode, std::shared_ptr<const Data>, bool>
@@ -3,29 +3,75 @@
 #ifndef SIMPLE_HPP_
 #define SIMPLE_HPP_
 
+#include <algorithm>
 #include <functional>
+#include <map>
+#include <memory>
 #include <random>
+#include <set>
+#include <sstream>
 #include <stdexcept>
+#include <string>
+#include <vector>
 
+#include "catch-up-fetcher.hpp"
+#include "data-store.hpp"
 #include "node.hpp"
+#include "rng-stream.hpp"
+#include "snapshot-service.hpp"
 
 namespace ndn {
 namespace vsync {
 namespace app {
 
+// Name component between a node ID and the object number in segment names.
+const char kObjectComponent[] = "obj";
+
 class SimpleNode {
  public:
   // First parameter is the new Data; second parameter indicates whether the
   // data is published locally.
   using DataEventTraceCb =
       std::function<void(std::shared_ptr<const Data>, bool)>;
+  // First parameter is one application message; second parameter indicates
+  // whether it is generated locally. A data item carries one message, or a
+  // batch of them when coalescing is enabled. In object mode every object is
+  // a message, received once the node holds all its segments.
+  using MessageEventTraceCb = std::function<void(const std::string&, bool)>;
+  // Parameter is the group's adaptive heartbeat interval for the period
+  // that ended at this node.
+  using HeartbeatTraceCb = std::function<void(time::milliseconds)>;
+  // Fired once the node has generated its last message, or when it joins
+  // sync if it has none to generate.
+  using PublishingDoneTraceCb = std::function<void()>;
+  // First parameter is the object ID; second is its size in bytes; third
+  // indicates whether the object is published locally. Fired at the
+  // publisher when the object is published and at a receiver once it holds
+  // every segment.
+  using ObjectEventTraceCb =
+      std::function<void(const std::string&, std::size_t, bool)>;
+  // Parameters are the member caught up with, how many items behind it the
+  // node was, and how long delivering them took.
+  using CatchUpTraceCb =
+      std::function<void(const Name&, uint64_t, time::milliseconds)>;
+  // Parameters are the number of items loaded from a snapshot and how long
+  // the bootstrap took.
+  using SnapshotTraceCb = std::function<void(std::size_t, time::milliseconds)>;
+  // Parameters are the number of items and bytes in the data store.
+  using DataStoreTraceCb = std::function<void(std::size_t, std::size_t)>;
+  // Parameter indicates whether a fetch of the node's data found the item
+  // still retained.
+  using FetchTraceCb = std::function<void(bool)>;
 
-  SimpleNode(const Name& nid, KeyChain& keychain, uint32_t seed,
-             double data_rate)
+  // |seed| and |run| identify the simulation run and |node_index| the node
+  // within it; together they select the node's random streams.
+  SimpleNode(const Name& nid, KeyChain& keychain, uint32_t seed, uint64_t run,
+             uint32_t node_index, double data_rate)
       : scheduler_(face_.getIoService()),
         key_chain_(keychain),
-        node_(face_, scheduler_, key_chain_, nid, seed),
-        rengine_(seed),
+        node_(face_, scheduler_, key_chain_, nid,
+              RngStream(seed, run, node_index, RngStream::kProtocolJitter)()),
+        rengine_(seed, run, node_index, RngStream::kPublishTiming),
         rdist_(data_rate) {
     node_.ConnectDataSignal(std::bind(&SimpleNode::OnData, this, _1));
   }
@@ -39,16 +85,138 @@ class SimpleNode {
 
     auto leader = vinfo.GetIDByIndex(vinfo.Size() - 1).first;
     node_.SetViewInfo({1, leader}, vinfo);
+    if (catch_up_) catch_up_->SetViewInfo(vinfo);
+  }
+
+  // Prefetches the missing items with an AIMD window of up to |max_window|
+  // interests whenever the node learns it is |threshold| or more items
+  // behind a member (see CatchUpFetcher). Call before SetViewInfo().
+  void EnableCatchUp(uint64_t threshold, std::size_t max_window) {
+    catch_up_.reset(new CatchUpFetcher(
+        face_, scheduler_, node_.GetNodeID(), threshold, max_window,
+        [this](const Name& member, uint64_t depth, time::nanoseconds t) {
+          catch_up_trace_(member, depth,
+                          time::duration_cast<time::milliseconds>(t));
+        }));
+    node_.ConnectVectorChangeSignal(
+        [this](std::size_t idx, const VersionVector& vv) {
+          catch_up_->OnVectorChange(idx, vv);
+        });
+    node_.ConnectViewChangeSignal(
+        [this](const ViewID&, const ViewInfo& vinfo, bool) {
+          catch_up_->SetViewInfo(vinfo);
+        });
+  }
+
+  // Switches the group to an adaptive heartbeat. The interval doubles after
+  // every heartbeat period in which no member published or received new
+  // data, up to |max|, and drops back to |min| on the next such activity.
+  //
+  // The library has one heartbeat interval for the whole process, not one
+  // per node, so the adaptation is group-wide: every adaptive node records
+  // its activity in state shared by all of them and writes the interval
+  // that follows from the group's last activity. All nodes thus agree on the
+  // interval, and members not in adaptive mode follow it too.
+  void EnableAdaptiveHeartbeat(time::milliseconds min,
+                               time::milliseconds max) {
+    adaptive_heartbeat_ = true;
+    hb_min_ = min;
+    hb_max_ = std::max(min, max);
+    hb_interval_ = min;
+  }
+
+  // Buffers the messages generated within |window| of the first one and
+  // publishes them as one data item, so they share one sync update and one
+  // fetch. A batch is published early once it holds |max_batch| messages.
+  // A zero window publishes every message on its own.
+  void SetCoalescing(time::milliseconds window, std::size_t max_batch) {
+    coalesce_window_ = window;
+    max_batch_ = std::max<std::size_t>(max_batch, 1);
+  }
+
+  // Makes every message an object of |object_size| bytes, cut into segments
+  // of |segment_size| bytes. By default an object is published as one sync
+  // update carrying a manifest, and receivers fetch its segments from the
+  // publisher with up to |window| interests in flight. If
+  // |segments_as_versions| is set, every segment is published as a sync
+  // update of its own instead. A zero |object_size| turns objects off.
+  void SetObjectMode(std::size_t object_size, std::size_t segment_size,
+                     std::size_t window, bool segments_as_versions) {
+    object_size_ = object_size;
+    segment_size_ = std::max<std::size_t>(segment_size, 1);
+    window_ = std::max<std::size_t>(window, 1);
+    segments_as_versions_ = segments_as_versions;
+  }
+
+  // Accounts the published and received Data the node would keep under
+  // |policy| (see DataStore). The sync node keeps its own copy of every item
+  // to answer fetches; the node watches those fetches and reports, through
+  // the Fetch trace, whether the item would still be retained. An unbounded
+  // policy keeps no account. Call before EnableSnapshots().
+  void SetRetentionPolicy(const RetentionPolicy& policy) {
+    bool bounded = policy.limit != RetentionPolicy::kUnbounded;
+    store_.reset(bounded ? new DataStore(policy, node_.GetNodeID().size())
+                         : nullptr);
+    watch_fetches_ = bounded;
+  }
+
+  // Serves the |horizon| most recent items of the data store as a snapshot
+  // to joining members (see SnapshotService). Keeps an unbounded store if
+  // there is none.
+  void EnableSnapshots(std::size_t horizon) {
+    if (!store_)
+      store_.reset(new DataStore(RetentionPolicy(), node_.GetNodeID().size()));
+    snapshot_.reset(new SnapshotService(face_, key_chain_, node_.GetNodeID(),
+                                        *store_, horizon));
+  }
+
+  // Makes Start() load a snapshot from |peer|, fetching up to |window|
+  // segments at a time, before the node joins sync. Items delivered from the
+  // snapshot are not delivered again when sync catches up on them, but sync
+  // still fetches them. Requires EnableSnapshots().
+  void SetBootstrapPeer(const Name& peer, std::size_t window) {
+    bootstrap_peer_ = peer;
+    bootstrap_window_ = window;
+  }
+
+  // Sets how many messages the node generates before it stops publishing.
+  void SetMaxDataCount(int max_data_count) {
+    max_data_count_ = max_data_count;
   }
 
   void Start() {
-    node_.Start();
-    scheduler_.scheduleEvent(
-        time::milliseconds(static_cast<int>(1000.0 * rdist_(rengine_))),
-        [this] { PublishData(); });
+    if (snapshot_) snapshot_->Serve();
+    if (snapshot_ && !bootstrap_peer_.empty()) {
+      snapshot_->Bootstrap(
+          bootstrap_peer_, bootstrap_window_,
+          [this](std::shared_ptr<const Data> data) {
+            snapshot_names_.insert(data->getName());
+            Deliver(data);
+          },
+          [this](std::size_t items, time::nanoseconds t) {
+            snapshot_trace_(items,
+                            time::duration_cast<time::milliseconds>(t));
+            StartSync();
+          });
+    } else {
+      StartSync();
+    }
     face_.processEvents();
   }
 
+  // Publishes messages received from outside the sync group, e.g. from
+  // another level of a hierarchical group, as one data item. They are
+  // reported as received messages. Plain messages only, not objects.
+  void Relay(const std::vector<std::string>& msgs) {
+    if (msgs.empty()) return;
+    std::string content;
+    for (const auto& msg : msgs) {
+      message_event_trace_(msg, false);
+      content += msg + '\n';
+    }
+    Publish(content);
+  }
+
   void ConnectVectorChangeTrace(Node::VectorChangeCb cb) {
     node_.ConnectVectorChangeSignal(cb);
   }
@@ -61,32 +229,398 @@ class SimpleNode {
     data_event_trace_.connect(cb);
   }
 
+  void ConnectMessageEventTrace(MessageEventTraceCb cb) {
+    message_event_trace_.connect(cb);
+  }
+
+  void ConnectHeartbeatTrace(HeartbeatTraceCb cb) {
+    heartbeat_trace_.connect(cb);
+  }
+
+  void ConnectPublishingDoneTrace(PublishingDoneTraceCb cb) {
+    publishing_done_trace_.connect(cb);
+  }
+
+  void ConnectObjectEventTrace(ObjectEventTraceCb cb) {
+    object_event_trace_.connect(cb);
+  }
+
+  void ConnectCatchUpTrace(CatchUpTraceCb cb) { catch_up_trace_.connect(cb); }
+
+  void ConnectSnapshotTrace(SnapshotTraceCb cb) {
+    snapshot_trace_.connect(cb);
+  }
+
+  void ConnectDataStoreTrace(DataStoreTraceCb cb) {
+    data_store_trace_.connect(cb);
+  }
+
+  void ConnectFetchTrace(FetchTraceCb cb) { fetch_trace_.connect(cb); }
+
  private:
+  void StartSync() {
+    if (adaptive_heartbeat_) {
+      SetHeartbeatInterval(hb_interval_);
+      hb_event_ = scheduler_.scheduleEvent(hb_interval_,
+                                           [this] { HeartbeatTick(); });
+    }
+    if (object_size_ > 0 && !segments_as_versions_)
+      face_.setInterestFilter(
+          Name(node_.GetNodeID()).append(kObjectComponent),
+          std::bind(&SimpleNode::OnSegmentInterest, this, _2),
+          [](const Name&, const std::string&) {});
+    if (watch_fetches_)
+      face_.setInterestFilter(node_.GetNodeID(),
+                              std::bind(&SimpleNode::OnFetch, this, _2),
+                              [](const Name&, const std::string&) {});
+    node_.Start();
+    if (max_data_count_ <= 0) {
+      publishing_done_trace_();
+      return;
+    }
+    scheduler_.scheduleEvent(
+        time::milliseconds(static_cast<int>(1000.0 * rdist_(rengine_))),
+        [this] { PublishData(); });
+  }
+
+  void Store(std::shared_ptr<const Data> data) {
+    if (!store_) return;
+    store_->Insert(data);
+    data_store_trace_(store_->Size(), store_->Bytes());
+  }
+
+  // Object segments and snapshots have filters of their own.
+  void OnFetch(const Interest& interest) {
+    const auto& name = interest.getName();
+    std::size_t n = node_.GetNodeID().size();
+    if (name.size() <= n ||
+        name.get(n) == name::Component(kObjectComponent) ||
+        name.get(n) == name::Component("snapshot"))
+      return;
+    fetch_trace_(store_->Find(name) != nullptr);
+  }
+
   void OnData(std::shared_ptr<const Data> data) {
+    if (snapshot_names_.erase(data->getName()) > 0) return;
+    TightenHeartbeat();
+    Deliver(data);
+  }
+
+  void Deliver(std::shared_ptr<const Data> data) {
+    if (catch_up_) catch_up_->OnData(data->getName());
+    Store(data);
     data_event_trace_(data, false);
+
+    const auto& content = data->getContent();
+    std::istringstream batch(std::string(
+        reinterpret_cast<const char*>(content.value()), content.value_size()));
+    std::string msg;
+    if (object_size_ > 0) {
+      std::getline(batch, msg);
+      OnObjectData(msg);
+      return;
+    }
+    while (std::getline(batch, msg)) message_event_trace_(msg, false);
+  }
+
+  // Objects are announced with a first content line of
+  //   manifest <object ID> <segment prefix> <segments> <bytes>
+  // or, when every segment is a version of its own,
+  //   segment <object ID> <index> <segments> <bytes>
+  // followed by the segment payload.
+  void OnObjectData(const std::string& header) {
+    std::istringstream is(header);
+    std::string kind, id, prefix;
+    std::size_t segments = 0, bytes = 0;
+    is >> kind >> id;
+    if (kind == "manifest") {
+      is >> prefix >> segments >> bytes;
+      if (!is || segments == 0) return;
+      auto& fetch = fetches_[prefix];
+      fetch.id = id;
+      fetch.prefix = Name(prefix);
+      fetch.segments = segments;
+      fetch.bytes = bytes;
+      FillWindow(prefix);
+    } else if (kind == "segment") {
+      std::size_t index = 0;
+      is >> index >> segments >> bytes;
+      if (!is) return;
+      if (++assembly_[id] < segments) return;
+      assembly_.erase(id);
+      object_event_trace_(id, bytes, false);
+      message_event_trace_(id, false);
+    }
+  }
+
+  struct Fetch {
+    std::string id;
+    Name prefix;
+    std::size_t segments = 0;
+    std::size_t bytes = 0;
+    std::size_t next = 0;
+    std::size_t received = 0;
+    std::size_t in_flight = 0;
+    std::map<std::size_t, int> retries;
+  };
+
+  void FillWindow(const std::string& key) {
+    auto& fetch = fetches_[key];
+    while (fetch.in_flight < window_ && fetch.next < fetch.segments)
+      ExpressSegmentInterest(key, fetch.next++);
+  }
+
+  void ExpressSegmentInterest(const std::string& key, std::size_t segment) {
+    auto& fetch = fetches_[key];
+    ++fetch.in_flight;
+    Interest interest(Name(fetch.prefix).appendSegment(segment));
+    interest.setInterestLifetime(kSegmentLifetime);
+    face_.expressInterest(
+        interest,
+        [this, key](const Interest&, const Data&) { OnSegment(key); },
+        [this, key, segment](const Interest&, const lp::Nack&) {
+          OnSegmentLoss(key, segment, true);
+        },
+        [this, key, segment](const Interest&) {
+          OnSegmentLoss(key, segment, false);
+        });
+  }
+
+  void OnSegment(const std::string& key) {
+    auto it = fetches_.find(key);
+    if (it == fetches_.end()) return;
+    --it->second.in_flight;
+    if (++it->second.received == it->second.segments) {
+      object_event_trace_(it->second.id, it->second.bytes, false);
+      message_event_trace_(it->second.id, false);
+      fetches_.erase(it);
+      return;
+    }
+    FillWindow(key);
+  }
+
+  // Retries a lost segment a few times, then gives the object up; its
+  // publisher may have left the group. A timed out interest has waited its
+  // lifetime already, but a Nack comes back at once, so the retry after a
+  // Nack waits kNackBackoff, doubled for every retry of the segment. The
+  // segment keeps its place in the window meanwhile.
+  void OnSegmentLoss(const std::string& key, std::size_t segment,
+                     bool nacked) {
+    auto it = fetches_.find(key);
+    if (it == fetches_.end()) return;
+    int retries = ++it->second.retries[segment];
+    if (retries > kSegmentRetries) {
+      fetches_.erase(it);
+      return;
+    }
+    if (!nacked) {
+      --it->second.in_flight;
+      ExpressSegmentInterest(key, segment);
+      return;
+    }
+    auto backoff =
+        std::min(kNackBackoff * (1 << (retries - 1)), kSegmentLifetime);
+    scheduler_.scheduleEvent(backoff, [this, key, segment] {
+      auto it = fetches_.find(key);
+      if (it == fetches_.end()) return;
+      --it->second.in_flight;
+      ExpressSegmentInterest(key, segment);
+    });
+  }
+
+  // Segments are named /<node ID>/<kObjectComponent>/<object>/<segment> and
+  // generated on demand.
+  void OnSegmentInterest(const Interest& interest) {
+    const auto& name = interest.getName();
+    if (name.size() < 2 || !name.get(-1).isSegment() ||
+        !name.get(-2).isNumber())
+      return;
+    uint64_t object = name.get(-2).toNumber();
+    uint64_t segment = name.get(-1).toSegment();
+    std::size_t segments = SegmentCount();
+    if (object == 0 || object > static_cast<uint64_t>(data_count_) ||
+        segment >= segments)
+      return;
+
+    auto data = std::make_shared<Data>(name);
+    std::string payload(SegmentBytes(segment), 'o');
+    data->setContent(reinterpret_cast<const uint8_t*>(payload.data()),
+                     payload.size());
+    key_chain_.sign(*data, security::signingWithSha256());
+    face_.put(*data);
+  }
+
+  std::size_t SegmentCount() const {
+    return (object_size_ + segment_size_ - 1) / segment_size_;
+  }
+
+  std::size_t SegmentBytes(std::size_t segment) const {
+    return std::min(segment_size_, object_size_ - segment * segment_size_);
+  }
+
+  void PublishObject(const std::string& id) {
+    std::size_t segments = SegmentCount();
+    object_event_trace_(id, object_size_, true);
+    if (segments_as_versions_) {
+      for (std::size_t i = 0; i < segments; ++i)
+        Publish("segment " + id + " " + std::to_string(i) + " " +
+                std::to_string(segments) + " " +
+                std::to_string(object_size_) + "\n" +
+                std::string(SegmentBytes(i), 'o'));
+      return;
+    }
+    Name prefix = Name(node_.GetNodeID())
+                      .append(kObjectComponent)
+                      .appendNumber(data_count_);
+    Publish("manifest " + id + " " + prefix.toUri() + " " +
+            std::to_string(segments) + " " + std::to_string(object_size_) +
+            "\n");
+  }
+
+  // Time of the last publication or new data at any adaptive node.
+  static time::steady_clock::TimePoint& GroupActivity() {
+    static time::steady_clock::TimePoint last_activity;
+    return last_activity;
+  }
+
+  // The interval starts at |hb_min_| after group activity and doubles at the
+  // end of every period that follows without any.
+  time::milliseconds GroupHeartbeatInterval() const {
+    auto quiet = time::steady_clock::now() - GroupActivity();
+    time::milliseconds interval = hb_min_;
+    time::nanoseconds elapsed = time::nanoseconds::zero();
+    while (interval < hb_max_ && elapsed + interval <= quiet) {
+      elapsed += interval;
+      interval *= 2;
+    }
+    return std::min(interval, hb_max_);
+  }
+
+  void HeartbeatTick() {
+    heartbeat_trace_(hb_interval_);
+    hb_interval_ = GroupHeartbeatInterval();
+    SetHeartbeatInterval(hb_interval_);
+    hb_event_ =
+        scheduler_.scheduleEvent(hb_interval_, [this] { HeartbeatTick(); });
+  }
+
+  void TightenHeartbeat() {
+    if (!adaptive_heartbeat_) return;
+    GroupActivity() = time::steady_clock::now();
+    SetHeartbeatInterval(hb_min_);
+    if (hb_interval_ == hb_min_) return;
+
+    hb_interval_ = hb_min_;
+    scheduler_.cancelEvent(hb_event_);
+    hb_event_ =
+        scheduler_.scheduleEvent(hb_interval_, [this] { HeartbeatTick(); });
   }
 
   void PublishData() {
-    if (++data_count_ > 100) return;
+    if (++data_count_ > max_data_count_) return;
     std::string msg =
         node_.GetNodeID().toUri() + ":" + std::to_string(data_count_);
-    auto data = node_.PublishData(msg);
-    data_event_trace_(data, true);
+    message_event_trace_(msg, true);
+    if (object_size_ > 0) {
+      PublishObject(msg);
+    } else if (coalesce_window_ > time::milliseconds::zero()) {
+      batch_.push_back(msg);
+      if (batch_.size() >= max_batch_)
+        FlushBatch();
+      else if (batch_.size() == 1)
+        batch_event_ = scheduler_.scheduleEvent(coalesce_window_,
+                                                [this] { FlushBatch(); });
+    } else {
+      Publish(msg);
+    }
+    if (data_count_ == max_data_count_) {
+      // No message will join the last batch, and publishing is done only
+      // once it is out.
+      FlushBatch();
+      publishing_done_trace_();
+      return;
+    }
     scheduler_.scheduleEvent(
         time::milliseconds(static_cast<int>(1000.0 * rdist_(rengine_))),
         [this] { PublishData(); });
   }
 
+  void FlushBatch() {
+    scheduler_.cancelEvent(batch_event_);
+    if (batch_.empty()) return;
+    std::string content;
+    for (const auto& msg : batch_) content += msg + '\n';
+    batch_.clear();
+    Publish(content);
+  }
+
+  void Publish(const std::string& content) {
+    TightenHeartbeat();
+    auto data = node_.PublishData(content);
+    if (catch_up_) catch_up_->OnLocalData(data->getName(), ++published_);
+    Store(data);
+    data_event_trace_(data, true);
+  }
+
   Face face_;
   Scheduler scheduler_;
   KeyChain& key_chain_;
   Node node_;
   int data_count_ = 0;
+  int max_data_count_ = 100;
+  // Sync updates published so far.
+  uint64_t published_ = 0;
 
-  std::mt19937 rengine_;
+  RngStream rengine_;
   std::exponential_distribution<> rdist_;
 
+  time::milliseconds coalesce_window_ = time::milliseconds::zero();
+  std::size_t max_batch_ = 1;
+  std::vector<std::string> batch_;
+  EventId batch_event_;
+
+  static constexpr int kSegmentRetries = 8;
+  const time::milliseconds kSegmentLifetime = time::milliseconds(1000);
+  const time::milliseconds kNackBackoff = time::milliseconds(50);
+
+  std::size_t object_size_ = 0;
+  std::size_t segment_size_ = 1024;
+  std::size_t window_ = 8;
+  bool segments_as_versions_ = false;
+  // Fetches in progress, by segment prefix.
+  std::map<std::string, Fetch> fetches_;
+  // Segments received so far of objects published segment by segment.
+  std::map<std::string, std::size_t> assembly_;
+
+  std::unique_ptr<CatchUpFetcher> catch_up_;
+
+  // Null unless a bounded retention policy or snapshots need it.
+  std::unique_ptr<DataStore> store_;
+  bool watch_fetches_ = false;
+
+  std::unique_ptr<SnapshotService> snapshot_;
+  Name bootstrap_peer_;
+  std::size_t bootstrap_window_ = 8;
+  // Items delivered from a snapshot that sync has not delivered yet.
+  std::set<Name> snapshot_names_;
+
+  bool adaptive_heartbeat_ = false;
+  time::milliseconds hb_min_;
+  time::milliseconds hb_max_;
+  time::milliseconds hb_interval_;
+  EventId hb_event_;
+
   util::Signal<SimpleNode, std::shared_ptr<const Data>, bool> data_event_trace_;
+  util::Signal<SimpleNode, const std::string&, bool> message_event_trace_;
+  util::Signal<SimpleNode, time::milliseconds> heartbeat_trace_;
+  util::Signal<SimpleNode> publishing_done_trace_;
+  util::Signal<SimpleNode, const std::string&, std::size_t, bool>
+      object_event_trace_;
+  util::Signal<SimpleNode, const Name&, uint64_t, time::milliseconds>
+      catch_up_trace_;
+  util::Signal<SimpleNode, std::size_t, time::milliseconds> snapshot_trace_;
+  util::Signal<SimpleNode, std::size_t, std::size_t> data_store_trace_;
+  util::Signal<SimpleNode, bool> fetch_trace_;
 };
 
 }  // namespace app
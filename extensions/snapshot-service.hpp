@@ -0,0 +1,306 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#ifndef SNAPSHOT_SERVICE_HPP_
+#define SNAPSHOT_SERVICE_HPP_
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <tuple>
+#include <vector>
+
+#include "data-store.hpp"
+#include "node.hpp"
+
+namespace ndn {
+namespace vsync {
+namespace app {
+
+// Lets a node that joins a long-lived group load the recent history from one
+// member in bulk instead of waiting for sync to deliver it.
+//
+// A member serves the |horizon| most recent items of its data store. A joiner
+// first fetches /<member>/snapshot/digest, which freezes those items into a
+// snapshot, or returns the last one if the items have not changed since, and
+// describes it as
+//   <version> <segments> <items>
+// The snapshot itself is streamed as /<member>/snapshot/<version>/<segment>,
+// each segment packing the wire encoding of several Data packets, with up to
+// |window| segment interests in flight. Only the latest kMaxSnapshots
+// snapshots are kept; an interest for an older one is answered with an
+// application Nack, on which the joiner starts over from the digest. Items
+// older than the horizon are left to normal sync.
+//
+// The library offers no way to seed a sync node's state, so sync still
+// fetches any item of the snapshot that it learns about; the application
+// only drops the second delivery. A snapshot shortens the time until a
+// joiner holds the history, not the traffic it costs.
+class SnapshotService {
+ public:
+  using ItemCb = std::function<void(std::shared_ptr<const Data>)>;
+  // Parameters are the number of items loaded and the time the bootstrap
+  // took; zero items if the member could not be reached.
+  using DoneCb = std::function<void(std::size_t, time::nanoseconds)>;
+
+  SnapshotService(Face& face, KeyChain& key_chain, const Name& nid,
+                  const DataStore& store, std::size_t horizon)
+      : face_(face),
+        key_chain_(key_chain),
+        prefix_(Name(nid).append("snapshot")),
+        store_(store),
+        horizon_(horizon) {}
+
+  void Serve() {
+    face_.setInterestFilter(
+        prefix_, std::bind(&SnapshotService::OnInterest, this, _2),
+        [](const Name&, const std::string&) {});
+  }
+
+  void Bootstrap(const Name& member, std::size_t window, ItemCb on_item,
+                 DoneCb done) {
+    joiner_.reset(new Joiner);
+    joiner_->peer = Name(member).append("snapshot");
+    joiner_->window = std::max<std::size_t>(window, 1);
+    joiner_->on_item = on_item;
+    joiner_->done = done;
+    joiner_->start = time::steady_clock::now();
+    FetchDigest();
+  }
+
+ private:
+  struct Joiner {
+    Name peer;
+    std::size_t window = 1;
+    ItemCb on_item;
+    DoneCb done;
+    time::steady_clock::TimePoint start;
+
+    Name snapshot;
+    std::size_t segments = 0;
+    std::size_t next = 0;
+    std::size_t received = 0;
+    std::size_t in_flight = 0;
+    std::size_t items = 0;
+    int retries = 0;
+  };
+
+  // A frozen snapshot, with what it was frozen from.
+  struct Snapshot {
+    std::vector<std::vector<uint8_t>> segments;
+    std::size_t items = 0;
+    Name first;
+    Name last;
+  };
+
+  static const int kMaxRetries = 8;
+  static const std::size_t kSegmentBytes = 1024;
+  // Frozen snapshots kept for joiners still streaming them.
+  static const std::size_t kMaxSnapshots = 2;
+
+  void OnInterest(const Interest& interest) {
+    const auto& name = interest.getName();
+    if (name.size() == prefix_.size() + 1 &&
+        name.get(-1) == name::Component("digest")) {
+      ServeDigest(name);
+      return;
+    }
+    if (name.size() != prefix_.size() + 2 || !name.get(-2).isVersion() ||
+        !name.get(-1).isSegment())
+      return;
+    auto it = snapshots_.find(name.get(-2).toVersion());
+    uint64_t segment = name.get(-1).toSegment();
+    auto data = std::make_shared<Data>(name);
+    if (it == snapshots_.end()) {
+      data->setContentType(tlv::ContentType_Nack);
+      data->setFreshnessPeriod(time::milliseconds(100));
+    } else if (segment < it->second.segments.size()) {
+      const auto& content = it->second.segments[segment];
+      data->setContent(content.data(), content.size());
+    } else {
+      return;
+    }
+    key_chain_.sign(*data, security::signingWithSha256());
+    face_.put(*data);
+  }
+
+  void ServeDigest(const Name& name) {
+    std::deque<std::shared_ptr<const Data>> items;
+    store_.ForEach([&](std::shared_ptr<const Data> item) {
+      items.push_back(item);
+      if (items.size() > horizon_) items.pop_front();
+    });
+
+    // The items are in arrival order, so the same size and ends mean the
+    // same items.
+    auto last = snapshots_.rbegin();
+    if (last == snapshots_.rend() || items.size() != last->second.items ||
+        (!items.empty() && (items.front()->getName() != last->second.first ||
+                            items.back()->getName() != last->second.last))) {
+      Snapshot& snapshot = snapshots_[++version_];
+      snapshot.items = items.size();
+      if (!items.empty()) {
+        snapshot.first = items.front()->getName();
+        snapshot.last = items.back()->getName();
+      }
+      for (const auto& item : items) {
+        const Block& wire = item->wireEncode();
+        if (snapshot.segments.empty() ||
+            snapshot.segments.back().size() + wire.size() > kSegmentBytes)
+          snapshot.segments.emplace_back();
+        snapshot.segments.back().insert(snapshot.segments.back().end(),
+                                        wire.begin(), wire.end());
+      }
+      while (snapshots_.size() > kMaxSnapshots)
+        snapshots_.erase(snapshots_.begin());
+      last = snapshots_.rbegin();
+    }
+
+    std::ostringstream os;
+    os << last->first << ' ' << last->second.segments.size() << ' '
+       << last->second.items << '\n';
+    std::string content = os.str();
+
+    auto data = std::make_shared<Data>(name);
+    data->setFreshnessPeriod(time::milliseconds(100));
+    data->setContent(reinterpret_cast<const uint8_t*>(content.data()),
+                     content.size());
+    key_chain_.sign(*data, security::signingWithSha256());
+    face_.put(*data);
+  }
+
+  void FetchDigest() {
+    Interest interest(Name(joiner_->peer).append("digest"));
+    interest.setMustBeFresh(true);
+    face_.expressInterest(
+        interest,
+        [this](const Interest&, const Data& data) { OnDigest(data); },
+        [this](const Interest&, const lp::Nack&) { OnDigestLost(); },
+        [this](const Interest&) { OnDigestLost(); });
+  }
+
+  void OnDigestLost() {
+    if (!joiner_) return;
+    if (++joiner_->retries <= kMaxRetries)
+      FetchDigest();
+    else
+      Finish();
+  }
+
+  void OnDigest(const Data& data) {
+    if (!joiner_) return;
+    const auto& content = data.getContent();
+    std::istringstream is(std::string(
+        reinterpret_cast<const char*>(content.value()), content.value_size()));
+    uint64_t version = 0;
+    is >> version >> joiner_->segments;
+    if (!is || joiner_->segments == 0) {
+      Finish();
+      return;
+    }
+    joiner_->snapshot = Name(joiner_->peer).appendVersion(version);
+    joiner_->retries = 0;
+    FillWindow();
+  }
+
+  void FillWindow() {
+    while (joiner_->in_flight < joiner_->window &&
+           joiner_->next < joiner_->segments)
+      FetchSegment(joiner_->next++);
+  }
+
+  void FetchSegment(std::size_t segment) {
+    ++joiner_->in_flight;
+    Name snapshot = joiner_->snapshot;
+    face_.expressInterest(
+        Interest(Name(snapshot).appendSegment(segment)),
+        [this](const Interest&, const Data& data) { OnSegment(data); },
+        [this, snapshot, segment](const Interest&, const lp::Nack&) {
+          OnSegmentLost(snapshot, segment);
+        },
+        [this, snapshot, segment](const Interest&) {
+          OnSegmentLost(snapshot, segment);
+        });
+  }
+
+  // Segments still in flight when a bootstrap is given up, or that belong
+  // to a dropped snapshot, are ignored.
+  void OnSegment(const Data& data) {
+    if (!joiner_ || joiner_->snapshot.empty() ||
+        !joiner_->snapshot.isPrefixOf(data.getName()))
+      return;
+    --joiner_->in_flight;
+    if (data.getContentType() == tlv::ContentType_Nack) {
+      OnSnapshotGone();
+      return;
+    }
+    const auto& content = data.getContent();
+    const uint8_t* p = content.value();
+    const uint8_t* end = p + content.value_size();
+    while (p < end) {
+      bool ok;
+      Block block;
+      std::tie(ok, block) = Block::fromBuffer(p, end - p);
+      if (!ok) break;
+      p += block.size();
+      ++joiner_->items;
+      joiner_->on_item(std::make_shared<Data>(block));
+    }
+    if (++joiner_->received == joiner_->segments) {
+      Finish();
+      return;
+    }
+    FillWindow();
+  }
+
+  // The member has dropped the snapshot: fetch the current one from the
+  // start. Items loaded already are suppressed by the caller if delivered
+  // again. Replies to the old snapshot's interests are ignored.
+  void OnSnapshotGone() {
+    if (++joiner_->retries > kMaxRetries) {
+      Finish();
+      return;
+    }
+    joiner_->snapshot.clear();
+    joiner_->segments = 0;
+    joiner_->next = 0;
+    joiner_->received = 0;
+    joiner_->in_flight = 0;
+    FetchDigest();
+  }
+
+  void OnSegmentLost(const Name& snapshot, std::size_t segment) {
+    if (!joiner_ || joiner_->snapshot != snapshot) return;
+    --joiner_->in_flight;
+    if (++joiner_->retries > kMaxRetries) {
+      Finish();
+      return;
+    }
+    FetchSegment(segment);
+  }
+
+  // Hands over to normal sync, whether or not the snapshot was complete.
+  void Finish() {
+    std::unique_ptr<Joiner> joiner(std::move(joiner_));
+    joiner->done(joiner->items, time::steady_clock::now() - joiner->start);
+  }
+
+  Face& face_;
+  KeyChain& key_chain_;
+  const Name prefix_;
+  const DataStore& store_;
+  const std::size_t horizon_;
+
+  uint64_t version_ = 0;
+  std::map<uint64_t, Snapshot> snapshots_;
+
+  std::unique_ptr<Joiner> joiner_;
+};
+
+}  // namespace app
+}  // namespace vsync
+}  // namespace ndn
+
+#endif  // SNAPSHOT_SERVICE_HPP_
@@ -0,0 +1,89 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#ifndef SPSC_RING_HPP_
+#define SPSC_RING_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <vector>
+
+namespace ndn {
+namespace vsync {
+namespace app {
+
+// Lock-free single-producer/single-consumer ring of variable-size records.
+//
+// The ring is placed in caller-provided memory, which may be shared between
+// processes (e.g. an anonymous MAP_SHARED mapping created before fork()), as
+// long as std::atomic<uint64_t> is lock-free. The producer only writes
+// tail_ and the consumer only writes head_; both are monotonic byte offsets
+// and each record is a 32-bit length followed by the payload.
+class SpscRing {
+ public:
+  static std::size_t Footprint(std::size_t capacity) {
+    return sizeof(SpscRing) + capacity;
+  }
+
+  static SpscRing* Create(void* memory, std::size_t capacity) {
+    return new (memory) SpscRing(capacity);
+  }
+
+  // Returns false, leaving the ring unchanged, if the record does not fit.
+  bool Push(const uint8_t* data, uint32_t size) {
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    uint64_t head = head_.load(std::memory_order_acquire);
+    if (capacity_ - (tail - head) < sizeof(size) + size) return false;
+
+    Copy(tail, reinterpret_cast<const uint8_t*>(&size), sizeof(size));
+    Copy(tail + sizeof(size), data, size);
+    tail_.store(tail + sizeof(size) + size, std::memory_order_release);
+    return true;
+  }
+
+  // Returns false if the ring is empty.
+  bool Pop(std::vector<uint8_t>& record) {
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    uint64_t tail = tail_.load(std::memory_order_acquire);
+    if (head == tail) return false;
+
+    uint32_t size;
+    Read(head, reinterpret_cast<uint8_t*>(&size), sizeof(size));
+    record.resize(size);
+    Read(head + sizeof(size), record.data(), size);
+    head_.store(head + sizeof(size) + size, std::memory_order_release);
+    return true;
+  }
+
+ private:
+  explicit SpscRing(std::size_t capacity) : capacity_(capacity) {}
+
+  uint8_t* Buffer() { return reinterpret_cast<uint8_t*>(this + 1); }
+
+  void Copy(uint64_t offset, const uint8_t* data, std::size_t size) {
+    std::size_t pos = offset % capacity_;
+    std::size_t first = std::min<std::size_t>(size, capacity_ - pos);
+    std::memcpy(Buffer() + pos, data, first);
+    std::memcpy(Buffer(), data + first, size - first);
+  }
+
+  void Read(uint64_t offset, uint8_t* data, std::size_t size) {
+    std::size_t pos = offset % capacity_;
+    std::size_t first = std::min<std::size_t>(size, capacity_ - pos);
+    std::memcpy(data, Buffer() + pos, first);
+    std::memcpy(data + first, Buffer(), size - first);
+  }
+
+  alignas(64) std::atomic<uint64_t> head_{0};
+  alignas(64) std::atomic<uint64_t> tail_{0};
+  alignas(64) const uint64_t capacity_;
+};
+
+}  // namespace app
+}  // namespace vsync
+}  // namespace ndn
+
+#endif  // SPSC_RING_HPP_
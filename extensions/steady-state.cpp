@@ -0,0 +1,130 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#include "steady-state.hpp"
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+NS_LOG_COMPONENT_DEFINE("ns3.ndn.vsync.SteadyStateDetector");
+
+namespace ns3 {
+namespace ndn {
+namespace vsync {
+
+static const std::size_t kMserBatch = 5;
+static const std::size_t kCiBatches = 20;
+// Two-sided 95% quantile of Student's t with kCiBatches - 1 degrees of
+// freedom.
+static const double kTQuantile = 2.093;
+
+void SteadyStateDetector::Add(double time, double value) {
+  samples_.emplace_back(time, value);
+}
+
+void SteadyStateDetector::EnableEarlyStop(double relative_width, Time period,
+                                          std::size_t min_samples) {
+  relative_width_ = relative_width;
+  period_ = period;
+  min_samples_ = min_samples;
+  Simulator::Schedule(period_, &SteadyStateDetector::Check, this);
+}
+
+double SteadyStateDetector::GetWarmupEnd() {
+  Analyze();
+  if (truncation_ >= samples_.size()) return 0.0;
+  return samples_[truncation_].first;
+}
+
+double SteadyStateDetector::GetMean() {
+  Analyze();
+  return mean_;
+}
+
+double SteadyStateDetector::GetHalfWidth() {
+  Analyze();
+  return half_width_;
+}
+
+void SteadyStateDetector::Analyze() {
+  if (analyzed_ == samples_.size()) return;
+  analyzed_ = samples_.size();
+
+  // MSER-5 over the batch means, using suffix sums so that every candidate
+  // truncation point costs O(1).
+  std::size_t m = analyzed_ / kMserBatch;
+  std::vector<double> batch(m, 0.0);
+  for (std::size_t i = 0; i < m * kMserBatch; ++i)
+    batch[i / kMserBatch] += samples_[i].second / kMserBatch;
+
+  std::vector<double> sum(m + 1, 0.0), sum_sq(m + 1, 0.0);
+  for (std::size_t i = m; i-- > 0;) {
+    sum[i] = sum[i + 1] + batch[i];
+    sum_sq[i] = sum_sq[i + 1] + batch[i] * batch[i];
+  }
+  std::size_t best = 0;
+  double best_mser = std::numeric_limits<double>::max();
+  for (std::size_t d = 0; m > 0 && d <= m / 2; ++d) {
+    double n = m - d;
+    double mser = (sum_sq[d] - sum[d] * sum[d] / n) / (n * n);
+    if (mser < best_mser) {
+      best_mser = mser;
+      best = d;
+    }
+  }
+  truncation_ = best * kMserBatch;
+
+  // Batch means of the observations kept.
+  std::size_t kept = analyzed_ - truncation_;
+  mean_ = 0.0;
+  half_width_ = std::numeric_limits<double>::infinity();
+  for (std::size_t i = truncation_; i < analyzed_; ++i)
+    mean_ += samples_[i].second;
+  if (kept > 0) mean_ /= kept;
+
+  std::size_t b = kept / kCiBatches;
+  if (b == 0) return;
+  double grand = 0.0;
+  std::vector<double> means(kCiBatches, 0.0);
+  for (std::size_t i = 0; i < b * kCiBatches; ++i)
+    means[i / b] += samples_[truncation_ + i].second / b;
+  for (double x : means) grand += x / kCiBatches;
+  double var = 0.0;
+  for (double x : means) var += (x - grand) * (x - grand);
+  var /= kCiBatches - 1;
+  half_width_ = kTQuantile * std::sqrt(var / kCiBatches);
+}
+
+void SteadyStateDetector::Check() {
+  Analyze();
+  if (analyzed_ - truncation_ >= min_samples_ && mean_ > 0.0 &&
+      half_width_ <= relative_width_ * mean_) {
+    stop_time_ = Simulator::Now().GetSeconds();
+    NS_LOG_INFO("converged at " << stop_time_ << "s: mean=" << mean_
+                                << ", half_width=" << half_width_);
+    Simulator::Stop();
+    return;
+  }
+  Simulator::Schedule(period_, &SteadyStateDetector::Check, this);
+}
+
+void SteadyStateDetector::Report() {
+  Analyze();
+  std::cout << "Warm-up end is: " << GetWarmupEnd() << " seconds."
+            << std::endl;
+  std::cout << "Observations discarded as warm-up is: " << truncation_
+            << std::endl;
+  std::cout << "Steady-state mean is: " << mean_ << std::endl;
+  std::cout << "Confidence interval half-width is: " << half_width_
+            << std::endl;
+  if (stop_time_ >= 0.0)
+    std::cout << "Early stop time is: " << stop_time_ << " seconds."
+              << std::endl;
+}
+
+}  // namespace vsync
+}  // namespace ndn
+}  // namespace ns3
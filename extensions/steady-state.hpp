@@ -0,0 +1,72 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#ifndef STEADY_STATE_HPP_
+#define STEADY_STATE_HPP_
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "ns3/nstime.h"
+
+namespace ns3 {
+namespace ndn {
+namespace vsync {
+
+// Online steady-state analysis of an output stream such as data delays.
+//
+// The end of the warm-up transient is found with MSER-5: observations are
+// averaged in batches of five and the truncation point is the number of
+// leading batches whose removal minimizes the squared standard error of the
+// mean of the rest, searched over the first half of the stream. The 95%
+// confidence interval of the steady-state mean comes from 20 batch means of
+// the observations kept.
+class SteadyStateDetector {
+ public:
+  // Records one observation |value| made at simulated |time| in seconds
+  // (e.g. the generation time of the data item whose delay it is).
+  void Add(double time, double value);
+
+  // Stops the simulation once the confidence interval half-width falls
+  // below |relative_width| times the steady-state mean. Checked every
+  // |period| once at least |min_samples| observations are kept.
+  void EnableEarlyStop(double relative_width, Time period,
+                       std::size_t min_samples = 200);
+
+  // Time of the first observation kept after the warm-up; observations made
+  // before it belong to the transient and should be excluded.
+  double GetWarmupEnd();
+
+  double GetMean();
+
+  double GetHalfWidth();
+
+  // Prints the warm-up end, steady-state mean and confidence interval, and
+  // when the simulation was stopped early, to stdout.
+  void Report();
+
+ private:
+  void Analyze();
+
+  void Check();
+
+ private:
+  std::vector<std::pair<double, double>> samples_;
+
+  // Results of the last analysis, valid for the first analyzed_ samples.
+  std::size_t analyzed_ = 0;
+  std::size_t truncation_ = 0;
+  double mean_ = 0.0;
+  double half_width_ = 0.0;
+
+  double relative_width_ = 0.0;
+  Time period_;
+  std::size_t min_samples_ = 0;
+  double stop_time_ = -1.0;
+};
+
+}  // namespace vsync
+}  // namespace ndn
+}  // namespace ns3
+
+#endif  // STEADY_STATE_HPP_
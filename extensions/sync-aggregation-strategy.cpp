@@ -0,0 +1,99 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#include "sync-aggregation-strategy.hpp"
+
+#include "ns3/ndnSIM/NFD/core/logger.hpp"
+#include "ns3/ndnSIM/NFD/core/scheduler.hpp"
+#include "ns3/ndnSIM/NFD/daemon/fw/algorithm.hpp"
+
+namespace nfd {
+namespace fw {
+
+NFD_LOG_INIT("SyncAggregationStrategy");
+
+const Name SyncAggregationStrategy::STRATEGY_NAME(
+    "ndn:/localhost/nfd/strategy/vsync-aggregation/%FD%01");
+
+time::milliseconds SyncAggregationStrategy::s_window(5);
+
+SyncAggregationStrategy::SyncAggregationStrategy(Forwarder& forwarder,
+                                                 const Name& name)
+    : Strategy(forwarder, name) {}
+
+void SyncAggregationStrategy::afterReceiveInterest(
+    const Face& inFace, const Interest& interest,
+    const shared_ptr<pit::Entry>& pitEntry) {
+  Name view_prefix;
+  ::ndn::vsync::VersionVector vv;
+  if (s_window <= time::milliseconds::zero() ||
+      !::ndn::vsync::app::ParseSyncInterestName(interest.getName(),
+                                                view_prefix, vv)) {
+    Multicast(inFace, interest, pitEntry);
+    return;
+  }
+
+  auto& batch = pending_[view_prefix];
+  for (const auto& p : batch) {
+    // Same name from another downstream: the PIT entry already recorded the
+    // new in-record and will be forwarded (or dropped) with the batch.
+    if (p.entry.lock() == pitEntry) return;
+  }
+
+  if (batch.empty())
+    scheduler::schedule(s_window, [this, view_prefix] { Flush(view_prefix); });
+  batch.push_back({pitEntry, inFace.getId(), std::move(vv)});
+}
+
+void SyncAggregationStrategy::Multicast(
+    const Face& inFace, const Interest& interest,
+    const shared_ptr<pit::Entry>& pitEntry) {
+  const fib::Entry& fibEntry = this->lookupFib(*pitEntry);
+  for (const auto& nexthop : fibEntry.getNextHops()) {
+    Face& outFace = nexthop.getFace();
+    if (!wouldViolateScope(inFace, interest, outFace) &&
+        canForwardToLegacy(*pitEntry, outFace)) {
+      this->sendInterest(pitEntry, outFace, interest);
+    }
+  }
+
+  if (!pitEntry->hasOutRecords()) this->rejectPendingInterest(pitEntry);
+}
+
+void SyncAggregationStrategy::Flush(const Name& view_prefix) {
+  auto it = pending_.find(view_prefix);
+  if (it == pending_.end()) return;
+  std::vector<PendingInterest> batch;
+  batch.swap(it->second);
+  pending_.erase(it);
+
+  for (std::size_t i = 0; i < batch.size(); ++i) {
+    auto entry = batch[i].entry.lock();
+    if (entry == nullptr) continue;
+
+    bool dominated = false;
+    for (std::size_t j = 0; j < batch.size() && !dominated; ++j) {
+      if (i == j || batch[j].entry.expired()) continue;
+      // Of two equal vectors, keep the one that arrived first.
+      if (::ndn::vsync::app::IsDominatedBy(batch[i].vv, batch[j].vv) &&
+          (j < i || !::ndn::vsync::app::IsDominatedBy(batch[j].vv,
+                                                      batch[i].vv)))
+        dominated = true;
+    }
+
+    if (dominated) {
+      NFD_LOG_DEBUG("suppress " << entry->getName());
+      this->rejectPendingInterest(entry);
+      continue;
+    }
+
+    Face* inFace = this->getFace(batch[i].in_face);
+    if (inFace == nullptr) {
+      this->rejectPendingInterest(entry);
+      continue;
+    }
+    Multicast(*inFace, entry->getInterest(), entry);
+  }
+}
+
+}  // namespace fw
+}  // namespace nfd
@@ -0,0 +1,59 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#ifndef SYNC_AGGREGATION_STRATEGY_HPP_
+#define SYNC_AGGREGATION_STRATEGY_HPP_
+
+#include <map>
+#include <vector>
+
+#include "ns3/ndnSIM/NFD/daemon/face/face.hpp"
+#include "ns3/ndnSIM/NFD/daemon/fw/strategy.hpp"
+
+#include "vsync-names.hpp"
+
+namespace nfd {
+namespace fw {
+
+// Multicast strategy for the sync prefix that holds sync interests for a
+// short window and fans out only those whose version vectors are not
+// dominated by another interest of the same view received in that window.
+// A dominated vector carries no state the dominating one does not, so its
+// PIT entry is dropped instead of being multicast to every other face.
+// Interests that do not parse as sync interests are multicast right away.
+class SyncAggregationStrategy : public Strategy {
+ public:
+  SyncAggregationStrategy(Forwarder& forwarder,
+                          const Name& name = STRATEGY_NAME);
+
+  void afterReceiveInterest(const Face& inFace, const Interest& interest,
+                            const shared_ptr<pit::Entry>& pitEntry) override;
+
+  // Applies to all instances created afterwards and to pending windows
+  // opened afterwards.
+  static void SetAggregationWindow(time::milliseconds window) {
+    s_window = window;
+  }
+
+  static const Name STRATEGY_NAME;
+
+ private:
+  struct PendingInterest {
+    weak_ptr<pit::Entry> entry;
+    FaceId in_face;
+    ::ndn::vsync::VersionVector vv;
+  };
+
+  void Multicast(const Face& inFace, const Interest& interest,
+                 const shared_ptr<pit::Entry>& pitEntry);
+
+  void Flush(const Name& view_prefix);
+
+  std::map<Name, std::vector<PendingInterest>> pending_;
+
+  static time::milliseconds s_window;
+};
+
+}  // namespace fw
+}  // namespace nfd
+
+#endif  // SYNC_AGGREGATION_STRATEGY_HPP_
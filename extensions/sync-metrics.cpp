@@ -0,0 +1,142 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#include "sync-metrics.hpp"
+
+#include <fstream>
+#include <iostream>
+
+#include "ns3/callback.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+NS_LOG_COMPONENT_DEFINE("ns3.ndn.vsync.SyncMetrics");
+
+namespace ns3 {
+namespace ndn {
+namespace vsync {
+
+void SyncMetrics::Connect(Ptr<Application> app, const std::string& nid) {
+  app->TraceConnect("DataEvent", nid,
+                    MakeCallback(&SyncMetrics::DataEvent, this));
+  app->TraceConnect("ViewChange", nid,
+                    MakeCallback(&SyncMetrics::ViewChange, this));
+}
+
+void SyncMetrics::DataEvent(std::string nid,
+                            std::shared_ptr<const Data> data, bool is_local) {
+  double now = Simulator::Now().GetSeconds();
+
+  auto& entry = delays_[data->getName().toUri()];
+  if (is_local) {
+    entry.first = now;
+  } else {
+    entry.second.push_back(now);
+    ++delivered_;
+    if (detector_ != nullptr &&
+        static_cast<int>(entry.second.size()) + 1 == GroupSizeAt(entry.first))
+      detector_->Add(entry.first, now - entry.first);
+  }
+}
+
+void SyncMetrics::ViewChange(std::string nid, const ::ndn::vsync::ViewID& vid,
+                             const ::ndn::vsync::ViewInfo& vinfo,
+                             bool is_leader) {
+  NS_LOG_INFO("node_id=\"" << nid << "\", is_leader=" << (is_leader ? 'Y' : 'N')
+                           << ", view_id=" << vid << ", view_info=" << vinfo);
+
+  double now = Simulator::Now().GetSeconds();
+
+  auto& entry = view_change_delays_[vid];
+  if (is_leader)
+    entry.first = now;
+  else
+    entry.second.push_back(now);
+}
+
+int SyncMetrics::GroupSizeAt(double time) const {
+  int gs = group_size_;
+  for (double t : departures_)
+    if (t <= time) --gs;
+  return gs;
+}
+
+void SyncMetrics::ReportDataDelays(const std::string& file_name,
+                                   bool write_sync_delay,
+                                   bool write_prop_delay) {
+  std::fstream fs_sync_delay;
+  std::fstream fs_prop_delay;
+  if (write_sync_delay)
+    fs_sync_delay.open(file_name + "-sync-delay",
+                       std::ios_base::out | std::ios_base::trunc);
+  if (write_prop_delay)
+    fs_prop_delay.open(file_name + "-prop-delay",
+                       std::ios_base::out | std::ios_base::trunc);
+
+  double warmup_end = detector_ != nullptr ? detector_->GetWarmupEnd() : 0.0;
+  int warmup_data = 0;
+  int fully_synchronized_data = 0;
+  double average_delay = 0.0;
+  double max_delay = 0.0;
+  for (auto iter = delays_.begin(); iter != delays_.end(); ++iter) {
+    const auto& s = iter->first;
+    double gen_time = iter->second.first;
+    const auto& vec = iter->second.second;
+    if (gen_time < warmup_end) {
+      ++warmup_data;
+      continue;
+    }
+    int gs = GroupSizeAt(gen_time);
+    if (vec.size() != gs - 1 || vec.size() == 0) {
+      std::cout << "name: " << s << ", gen_time: " << gen_time
+                << ", group_size: " << gs << ", vec.size: " << vec.size()
+                << std::endl;
+      continue;
+    }
+    ++fully_synchronized_data;
+    double max_time = 0.0;
+    for (auto iter2 = vec.begin(); iter2 != vec.end(); ++iter2) {
+      if (*iter2 > max_time) max_time = *iter2;
+      if (write_prop_delay)
+        fs_prop_delay << gen_time << '\t' << *iter2 << std::endl;
+    }
+
+    if (write_sync_delay)
+      fs_sync_delay << gen_time << '\t' << max_time << std::endl;
+
+    double d = max_time - gen_time;
+    if (max_delay < d) max_delay = d;
+    average_delay += d;
+  }
+  if (fully_synchronized_data > 0) average_delay /= fully_synchronized_data;
+
+  std::cout << "Total number of data published is: " << delays_.size()
+            << std::endl;
+  if (detector_ != nullptr)
+    std::cout << "Total number of data excluded as warm-up is: "
+              << warmup_data << std::endl;
+  std::cout << "Total number of data fully synchronized is: "
+            << fully_synchronized_data << std::endl;
+  std::cout << "Max data propagation delay is: " << max_delay << " seconds."
+            << std::endl;
+  std::cout << "Average data propagation delay is: " << average_delay
+            << " seconds." << std::endl;
+}
+
+void SyncMetrics::ReportViewChangeDelays() {
+  double max_view_change_delay = 0.0;
+  for (auto iter = view_change_delays_.begin();
+       iter != view_change_delays_.end(); ++iter) {
+    double start = iter->second.first;
+    const auto& vec = iter->second.second;
+    for (auto iter2 = vec.begin(); iter2 != vec.end(); ++iter2) {
+      double d = *iter2 - start;
+      if (d > max_view_change_delay) max_view_change_delay = d;
+    }
+  }
+  std::cout << "Max view change delay is: " << max_view_change_delay
+            << " seconds." << std::endl;
+}
+
+}  // namespace vsync
+}  // namespace ndn
+}  // namespace ns3
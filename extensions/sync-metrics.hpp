@@ -0,0 +1,80 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#ifndef SYNC_METRICS_HPP_
+#define SYNC_METRICS_HPP_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ns3/application.h"
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include "node.hpp"
+#include "steady-state.hpp"
+
+namespace ns3 {
+namespace ndn {
+namespace vsync {
+
+// Collects the DataEvent and ViewChange traces of a sync group and produces
+// the delay files and summary the scenarios print after a run.
+//
+// A data item counts as fully synchronized when it reached every member
+// that was still in the group when it was published.
+class SyncMetrics {
+ public:
+  explicit SyncMetrics(int group_size) : group_size_(group_size) {}
+
+  void Connect(Ptr<Application> app, const std::string& nid);
+
+  // Records that one member leaves the group at |time| seconds.
+  void AddDeparture(double time) { departures_.push_back(time); }
+
+  // Feeds the sync delay of every fully synchronized data item to
+  // |detector|; the delay report then leaves out data published during the
+  // warm-up it detects.
+  void SetSteadyStateDetector(SteadyStateDetector* detector) {
+    detector_ = detector;
+  }
+
+  // Writes <file_name>-sync-delay and <file_name>-prop-delay (when enabled)
+  // and prints the data propagation summary to stdout.
+  void ReportDataDelays(const std::string& file_name, bool write_sync_delay,
+                        bool write_prop_delay);
+
+  void ReportViewChangeDelays();
+
+  uint64_t GetPublishedCount() const { return delays_.size(); }
+
+  uint64_t GetDeliveredCount() const { return delivered_; }
+
+ private:
+  void DataEvent(std::string nid, std::shared_ptr<const Data> data,
+                 bool is_local);
+
+  void ViewChange(std::string nid, const ::ndn::vsync::ViewID& vid,
+                  const ::ndn::vsync::ViewInfo& vinfo, bool is_leader);
+
+  int GroupSizeAt(double time) const;
+
+ private:
+  int group_size_;
+  std::vector<double> departures_;
+  uint64_t delivered_ = 0;
+  SteadyStateDetector* detector_ = nullptr;
+
+  std::unordered_map<std::string, std::pair<double, std::vector<double>>>
+      delays_;
+  std::map<::ndn::vsync::ViewID, std::pair<double, std::vector<double>>,
+           ::ndn::vsync::VIDCompare>
+      view_change_delays_;
+};
+
+}  // namespace vsync
+}  // namespace ndn
+}  // namespace ns3
+
+#endif  // SYNC_METRICS_HPP_
@@ -0,0 +1,55 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#include "traffic-counter.hpp"
+
+#include "ns3/node-list.h"
+#include "ns3/node.h"
+
+#include "ns3/ndnSIM/model/ndn-l3-protocol.hpp"
+
+#include "node.hpp"
+
+namespace ns3 {
+namespace ndn {
+namespace vsync {
+
+std::array<uint64_t, TrafficCounter::kNumClasses> TrafficCounter::s_packets{};
+std::array<uint64_t, TrafficCounter::kNumClasses> TrafficCounter::s_bytes{};
+
+void TrafficCounter::InstallAll() {
+  NodeContainer nodes;
+  for (auto node = NodeList::Begin(); node != NodeList::End(); ++node)
+    nodes.Add(*node);
+  Install(nodes);
+}
+
+void TrafficCounter::Install(const NodeContainer& nodes) {
+  for (auto node = nodes.Begin(); node != nodes.End(); ++node) {
+    Ptr<L3Protocol> l3 = (*node)->GetObject<L3Protocol>();
+    if (l3 == nullptr) continue;
+    l3->TraceConnectWithoutContext("OutInterests",
+                                   MakeCallback(&TrafficCounter::OutInterests));
+    l3->TraceConnectWithoutContext("OutData",
+                                   MakeCallback(&TrafficCounter::OutData));
+  }
+}
+
+void TrafficCounter::OutInterests(const Interest& interest,
+                                  const nfd::Face& face) {
+  if (face.getScope() == ::ndn::nfd::FACE_SCOPE_LOCAL) return;
+  PacketClass c = ::ndn::vsync::kSyncPrefix.isPrefixOf(interest.getName())
+                      ? kSyncInterest
+                      : kDataInterest;
+  ++s_packets[c];
+  s_bytes[c] += interest.wireEncode().size();
+}
+
+void TrafficCounter::OutData(const Data& data, const nfd::Face& face) {
+  if (face.getScope() == ::ndn::nfd::FACE_SCOPE_LOCAL) return;
+  ++s_packets[kData];
+  s_bytes[kData] += data.wireEncode().size();
+}
+
+}  // namespace vsync
+}  // namespace ndn
+}  // namespace ns3
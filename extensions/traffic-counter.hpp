@@ -0,0 +1,55 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#ifndef TRAFFIC_COUNTER_HPP_
+#define TRAFFIC_COUNTER_HPP_
+
+#include <array>
+#include <cstdint>
+
+#include "ns3/node-container.h"
+
+#include "ns3/ndnSIM/NFD/daemon/face/face.hpp"
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+namespace ns3 {
+namespace ndn {
+namespace vsync {
+
+// Counts packets and wire bytes sent on non-local faces, i.e. what actually
+// crosses the links, split into sync interests, data interests and Data.
+// Totals are summed over every node the counter is installed on.
+class TrafficCounter {
+ public:
+  enum PacketClass {
+    kSyncInterest = 0,
+    kDataInterest = 1,
+    kData = 2,
+    kNumClasses = 3
+  };
+
+  static void InstallAll();
+
+  static void Install(const NodeContainer& nodes);
+
+  static uint64_t GetPackets(PacketClass c) { return s_packets[c]; }
+
+  static uint64_t GetBytes(PacketClass c) { return s_bytes[c]; }
+
+  static uint64_t GetTotalBytes() {
+    return s_bytes[kSyncInterest] + s_bytes[kDataInterest] + s_bytes[kData];
+  }
+
+ private:
+  static void OutInterests(const Interest& interest, const nfd::Face& face);
+
+  static void OutData(const Data& data, const nfd::Face& face);
+
+  static std::array<uint64_t, kNumClasses> s_packets;
+  static std::array<uint64_t, kNumClasses> s_bytes;
+};
+
+}  // namespace vsync
+}  // namespace ndn
+}  // namespace ns3
+
+#endif  // TRAFFIC_COUNTER_HPP_
@@ -0,0 +1,38 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#ifndef VSYNC_NAMES_HPP_
+#define VSYNC_NAMES_HPP_
+
+#include "node.hpp"
+#include "vsync-helper.hpp"
+#include "vv-kernels.hpp"
+
+namespace ndn {
+namespace vsync {
+namespace app {
+
+// Sync interests are named /<kSyncPrefix>/<view-id>/<version-vector>. Splits
+// |name| into the part that identifies the view and the version vector the
+// sender carried. Returns false if |name| is not a sync interest.
+inline bool ParseSyncInterestName(const Name& name, Name& view_prefix,
+                                  VersionVector& vv) {
+  if (!kSyncPrefix.isPrefixOf(name) || name.size() < kSyncPrefix.size() + 2)
+    return false;
+
+  vv = DecodeVVFromName(name.get(-1));
+  view_prefix = name.getPrefix(-1);
+  return true;
+}
+
+// Returns true if every entry of |a| is less than or equal to the matching
+// entry of |b|, i.e. |b| carries at least everything |a| does.
+inline bool IsDominatedBy(const VersionVector& a, const VersionVector& b) {
+  return a.size() == b.size() &&
+         GetVVKernels().is_dominated_by(a.data(), b.data(), a.size());
+}
+
+}  // namespace app
+}  // namespace vsync
+}  // namespace ndn
+
+#endif  // VSYNC_NAMES_HPP_
@@ -0,0 +1,157 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#ifndef VV_CODEC_HPP_
+#define VV_CODEC_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ndn {
+namespace vsync {
+namespace app {
+
+// Compact encoding of a version vector relative to a base vector that both
+// sides hold, e.g. the vector of the current view when it was formed, or the
+// last vector the sender put in a sync interest.
+//
+// Every entry is coded as the zigzag varint of its delta against the base,
+// so entries near the base take one byte whatever their magnitude. Two forms
+// exist, each starting with a mode byte and the varint number of entries:
+//
+//   kDense   the deltas in order, where a zero delta is followed by the
+//            varint length of the run of zero deltas it starts
+//   kSparse  the varint number of changed entries, then for each one the
+//            varint gap from the previous changed index and its delta
+//
+// Base entries past the end of the base are taken as zero.
+class VVCodec {
+ public:
+  using VV = std::vector<uint64_t>;
+
+  enum Mode : uint8_t { kDense = 0, kSparse = 1 };
+
+  // Longest vector Decode accepts.
+  static const uint64_t kMaxEntries = 1 << 20;
+
+  static std::vector<uint8_t> EncodeDense(const VV& vv, const VV& base) {
+    std::vector<uint8_t> out;
+    out.push_back(kDense);
+    PutVarint(vv.size(), out);
+    for (std::size_t i = 0; i < vv.size();) {
+      uint64_t zz = ZigZag(vv[i] - At(base, i));
+      PutVarint(zz, out);
+      ++i;
+      if (zz != 0) continue;
+      uint64_t run = 1;
+      for (; i < vv.size() && vv[i] == At(base, i); ++i) ++run;
+      PutVarint(run, out);
+    }
+    return out;
+  }
+
+  static std::vector<uint8_t> EncodeSparse(const VV& vv, const VV& base) {
+    std::vector<std::size_t> changed;
+    for (std::size_t i = 0; i < vv.size(); ++i)
+      if (vv[i] != At(base, i)) changed.push_back(i);
+
+    std::vector<uint8_t> out;
+    out.push_back(kSparse);
+    PutVarint(vv.size(), out);
+    PutVarint(changed.size(), out);
+    std::size_t next = 0;
+    for (std::size_t i : changed) {
+      PutVarint(i - next, out);
+      PutVarint(ZigZag(vv[i] - At(base, i)), out);
+      next = i + 1;
+    }
+    return out;
+  }
+
+  // The shorter of the two forms; only the dense one if |allow_sparse| is
+  // false.
+  static std::vector<uint8_t> Encode(const VV& vv, const VV& base,
+                                     bool allow_sparse = true) {
+    std::vector<uint8_t> dense = EncodeDense(vv, base);
+    if (!allow_sparse) return dense;
+    std::vector<uint8_t> sparse = EncodeSparse(vv, base);
+    return sparse.size() < dense.size() ? sparse : dense;
+  }
+
+  // Returns false if |size| bytes at |p| are not a valid encoding.
+  static bool Decode(const uint8_t* p, std::size_t size, const VV& base,
+                     VV& vv) {
+    const uint8_t* end = p + size;
+    if (p == end) return false;
+    uint8_t mode = *p++;
+    uint64_t n;
+    if ((mode != kDense && mode != kSparse) || !GetVarint(p, end, n) ||
+        n > kMaxEntries)
+      return false;
+    vv.resize(n);
+    for (std::size_t i = 0; i < n; ++i) vv[i] = At(base, i);
+
+    if (mode == kSparse) {
+      uint64_t count;
+      if (!GetVarint(p, end, count)) return false;
+      uint64_t next = 0;
+      for (uint64_t k = 0; k < count; ++k) {
+        uint64_t gap, zz;
+        if (!GetVarint(p, end, gap) || !GetVarint(p, end, zz) ||
+            gap >= n - next)
+          return false;
+        next += gap;
+        vv[next] += UnZigZag(zz);
+        ++next;
+      }
+      return p == end;
+    }
+
+    for (uint64_t i = 0; i < n;) {
+      uint64_t zz;
+      if (!GetVarint(p, end, zz)) return false;
+      if (zz != 0) {
+        vv[i++] += UnZigZag(zz);
+        continue;
+      }
+      uint64_t run;
+      if (!GetVarint(p, end, run) || run == 0 || run > n - i) return false;
+      i += run;
+    }
+    return p == end;
+  }
+
+  // LEB128: seven bits per byte, least significant first.
+  static void PutVarint(uint64_t v, std::vector<uint8_t>& out) {
+    for (; v >= 0x80; v >>= 7) out.push_back(static_cast<uint8_t>(v | 0x80));
+    out.push_back(static_cast<uint8_t>(v));
+  }
+
+  static bool GetVarint(const uint8_t*& p, const uint8_t* end, uint64_t& v) {
+    v = 0;
+    for (int shift = 0; p != end && shift < 64; shift += 7) {
+      uint8_t byte = *p++;
+      v |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) return true;
+    }
+    return false;
+  }
+
+ private:
+  static uint64_t At(const VV& vv, std::size_t i) {
+    return i < vv.size() ? vv[i] : 0;
+  }
+
+  // Deltas are taken modulo 2^64 and read as signed.
+  static uint64_t ZigZag(uint64_t delta) {
+    return (delta << 1) ^ (0 - (delta >> 63));
+  }
+
+  static uint64_t UnZigZag(uint64_t zz) { return (zz >> 1) ^ (0 - (zz & 1)); }
+};
+
+}  // namespace app
+}  // namespace vsync
+}  // namespace ndn
+
+#endif  // VV_CODEC_HPP_
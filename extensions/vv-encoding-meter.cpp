@@ -0,0 +1,122 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#include "vv-encoding-meter.hpp"
+
+#include <iostream>
+#include <vector>
+
+#include "ns3/node-list.h"
+#include "ns3/node.h"
+
+#include "ns3/ndnSIM/model/ndn-l3-protocol.hpp"
+
+#include "vsync-names.hpp"
+#include "vv-codec.hpp"
+
+namespace ns3 {
+namespace ndn {
+namespace vsync {
+
+using ::ndn::vsync::app::VVCodec;
+
+void VVEncodingMeter::InstallAll() {
+  NodeContainer nodes;
+  for (auto node = NodeList::Begin(); node != NodeList::End(); ++node)
+    nodes.Add(*node);
+  Install(nodes);
+}
+
+void VVEncodingMeter::Install(const NodeContainer& nodes) {
+  for (auto node = nodes.Begin(); node != nodes.End(); ++node) {
+    Ptr<L3Protocol> l3 = (*node)->GetObject<L3Protocol>();
+    if (l3 == nullptr) continue;
+    std::string id = std::to_string((*node)->GetId());
+    l3->TraceConnect("InInterests", id,
+                     MakeCallback(&VVEncodingMeter::InInterests, this));
+    l3->TraceConnect("OutInterests", id,
+                     MakeCallback(&VVEncodingMeter::OutInterests, this));
+  }
+}
+
+// An interest from a local face comes from an application on |node|, i.e.
+// |node| is its sender.
+void VVEncodingMeter::InInterests(std::string node, const Interest& interest,
+                                  const nfd::Face& face) {
+  if (face.getScope() != ::ndn::nfd::FACE_SCOPE_LOCAL) return;
+  if (!::ndn::vsync::kSyncPrefix.isPrefixOf(interest.getName())) return;
+
+  // A sender repeating a name, e.g. after a loss, costs what it did the
+  // first time.
+  auto it = sizes_.find(interest.getName());
+  if (it != sizes_.end()) {
+    if (it->second.sender != node) it->second = Measure(node, interest);
+    return;
+  }
+  sizes_.emplace(interest.getName(), Measure(node, interest));
+  names_.push_back(interest.getName());
+  if (names_.size() > kMaxNames) {
+    sizes_.erase(names_.front());
+    names_.pop_front();
+  }
+}
+
+void VVEncodingMeter::OutInterests(std::string node, const Interest& interest,
+                                   const nfd::Face& face) {
+  if (face.getScope() == ::ndn::nfd::FACE_SCOPE_LOCAL) return;
+  if (!::ndn::vsync::kSyncPrefix.isPrefixOf(interest.getName())) return;
+
+  std::size_t size = interest.wireEncode().size();
+  auto it = sizes_.find(interest.getName());
+  ++interests_;
+  bytes_ += size;
+  dense_bytes_ += it != sizes_.end() ? it->second.dense : size;
+  incremental_bytes_ += it != sizes_.end() ? it->second.incremental : size;
+}
+
+VVEncodingMeter::Sizes VVEncodingMeter::Measure(const std::string& node,
+                                                const Interest& interest) {
+  std::size_t size = interest.wireEncode().size();
+  Name view_prefix;
+  ::ndn::vsync::VersionVector vv;
+  if (!::ndn::vsync::app::ParseSyncInterestName(interest.getName(),
+                                                view_prefix, vv))
+    return {node, size, size};
+
+  auto wire_size = [&](const std::vector<uint8_t>& encoded) {
+    Name name(view_prefix);
+    name.append(encoded.data(), encoded.size());
+    Interest compact(interest);
+    compact.setName(name);
+    return compact.wireEncode().size();
+  };
+
+  const auto& view_base = view_bases_.emplace(view_prefix, vv).first->second;
+  auto& last = last_sent_[{node, view_prefix}];
+  Sizes sizes;
+  sizes.sender = node;
+  sizes.dense = wire_size(VVCodec::EncodeDense(vv, view_base));
+  sizes.incremental = wire_size(VVCodec::Encode(vv, last));
+  last = vv;
+  return sizes;
+}
+
+void VVEncodingMeter::Report() const {
+  std::cout << "Sync interests sent is: " << interests_ << std::endl;
+  if (interests_ == 0) return;
+  std::cout << "Bytes per sync interest is: "
+            << static_cast<double>(bytes_) / interests_ << std::endl;
+  std::cout << "Compact bytes per sync interest is: "
+            << static_cast<double>(dense_bytes_) / interests_ << std::endl;
+  std::cout << "Incremental bytes per sync interest is: "
+            << static_cast<double>(incremental_bytes_) / interests_
+            << std::endl;
+  std::cout << "Sync overhead bytes is: " << bytes_ << std::endl;
+  std::cout << "Compact sync overhead bytes is: " << dense_bytes_
+            << std::endl;
+  std::cout << "Incremental sync overhead bytes is: " << incremental_bytes_
+            << std::endl;
+}
+
+}  // namespace vsync
+}  // namespace ndn
+}  // namespace ns3
@@ -0,0 +1,79 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#ifndef VV_ENCODING_METER_HPP_
+#define VV_ENCODING_METER_HPP_
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <string>
+
+#include "ns3/node-container.h"
+
+#include "ns3/ndnSIM/NFD/daemon/face/face.hpp"
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include "node.hpp"
+
+namespace ns3 {
+namespace ndn {
+namespace vsync {
+
+// Measures what sync interests would cost with their version vector in the
+// compact VVCodec encoding instead of the library's, without changing what
+// is sent.
+//
+// Every sync interest is re-encoded twice and its wire size recomputed when
+// it leaves its sender: once in the dense form, against the base of its view
+// (the first vector seen in that view), and once in the shorter of the dense
+// and sparse forms against the last vector the same sender put in a sync
+// interest, which every member has heard on a multicast sync prefix. The
+// name does not carry the sender, so the sender is the node whose
+// application handed the interest to its forwarder. Every copy sent on a
+// non-local face is counted with those sizes; a copy whose sizes have been
+// forgotten counts at its own size in every encoding.
+class VVEncodingMeter {
+ public:
+  void InstallAll();
+
+  void Install(const NodeContainer& nodes);
+
+  // Prints the sync interest count and bytes per sync interest and in total
+  // for each encoding.
+  void Report() const;
+
+ private:
+  struct Sizes {
+    std::string sender;
+    std::size_t dense;
+    std::size_t incremental;
+  };
+
+  // Names remembered so that forwarded copies are not re-encoded.
+  static const std::size_t kMaxNames = 4096;
+
+  void InInterests(std::string node, const Interest& interest,
+                   const nfd::Face& face);
+
+  void OutInterests(std::string node, const Interest& interest,
+                    const nfd::Face& face);
+
+  Sizes Measure(const std::string& node, const Interest& interest);
+
+  std::map<Name, ::ndn::vsync::VersionVector> view_bases_;
+  std::map<std::pair<std::string, Name>, ::ndn::vsync::VersionVector>
+      last_sent_;
+  std::map<Name, Sizes> sizes_;
+  std::deque<Name> names_;
+
+  uint64_t interests_ = 0;
+  uint64_t bytes_ = 0;
+  uint64_t dense_bytes_ = 0;
+  uint64_t incremental_bytes_ = 0;
+};
+
+}  // namespace vsync
+}  // namespace ndn
+}  // namespace ns3
+
+#endif  // VV_ENCODING_METER_HPP_
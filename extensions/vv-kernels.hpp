@@ -0,0 +1,291 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#ifndef VV_KERNELS_HPP_
+#define VV_KERNELS_HPP_
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <vector>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define VV_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+namespace ndn {
+namespace vsync {
+namespace app {
+
+// Element-wise kernels over version vectors, i.e. arrays of uint64_t
+// sequence numbers indexed by member. Every sync interest and heartbeat
+// compares or merges two of them, so with thousands of members these loops
+// dominate the per-packet cost at a node.
+//
+// The AVX2 and SSE4.2 variants are compiled with target attributes and
+// chosen at run time from the CPU, so they need no build flags; elsewhere
+// only the scalar variants exist. With two lanes, SSE4.2 beats the scalar
+// loops only at the dominance test, so its merge and diff are the scalar
+// ones. All variants take unaligned arrays of any
+// length. PackedVV below is the layout they run fastest on.
+enum class VVIsa { kScalar, kSse42, kAvx2 };
+
+struct VVKernels {
+  // Returns true if a[i] <= b[i] for every i < n.
+  bool (*is_dominated_by)(const uint64_t* a, const uint64_t* b,
+                          std::size_t n);
+  // Sets dst[i] = max(dst[i], src[i]); returns true if dst changed.
+  bool (*merge)(uint64_t* dst, const uint64_t* src, std::size_t n);
+  // Appends to |out| every i with a[i] > b[i], i.e. the members for which |a|
+  // has news for |b|, in increasing order; returns how many were appended.
+  std::size_t (*diff)(const uint64_t* a, const uint64_t* b, std::size_t n,
+                      std::vector<std::size_t>& out);
+};
+
+namespace vv_detail {
+
+inline bool IsDominatedByScalar(const uint64_t* a, const uint64_t* b,
+                                std::size_t n) {
+  for (std::size_t i = 0; i < n; ++i)
+    if (a[i] > b[i]) return false;
+  return true;
+}
+
+// Finds the first entry that grows, and only from there runs the plain max
+// loop, with nothing else in it; dst changed iff there is such an entry.
+inline bool MergeScalar(uint64_t* dst, const uint64_t* src, std::size_t n) {
+  std::size_t i = 0;
+  while (i < n && src[i] <= dst[i]) ++i;
+  if (i == n) return false;
+  for (; i < n; ++i) dst[i] = std::max(dst[i], src[i]);
+  return true;
+}
+
+inline std::size_t DiffScalar(const uint64_t* a, const uint64_t* b,
+                              std::size_t n, std::vector<std::size_t>& out) {
+  std::size_t count = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    if (a[i] > b[i]) {
+      out.push_back(i);
+      ++count;
+    }
+  }
+  return count;
+}
+
+#ifdef VV_KERNELS_X86
+
+// There is no unsigned 64-bit compare before AVX-512, so both sides are
+// biased by 2^63 and compared signed.
+
+__attribute__((target("avx2"))) inline __m256i GreaterAvx2(const uint64_t* a,
+                                                           const uint64_t* b) {
+  const __m256i bias = _mm256_set1_epi64x(INT64_MIN);
+  __m256i x = _mm256_xor_si256(
+      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a)), bias);
+  __m256i y = _mm256_xor_si256(
+      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b)), bias);
+  return _mm256_cmpgt_epi64(x, y);
+}
+
+__attribute__((target("avx2"))) inline bool IsDominatedByAvx2(
+    const uint64_t* a, const uint64_t* b, std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256i gt = GreaterAvx2(a + i, b + i);
+    if (!_mm256_testz_si256(gt, gt)) return false;
+  }
+  return IsDominatedByScalar(a + i, b + i, n - i);
+}
+
+// Like MergeScalar, skips the entries that do not grow before storing any.
+__attribute__((target("avx2"))) inline bool MergeAvx2(uint64_t* dst,
+                                                     const uint64_t* src,
+                                                     std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256i gt = GreaterAvx2(src + i, dst + i);
+    if (!_mm256_testz_si256(gt, gt)) break;
+  }
+  if (i + 4 > n) return MergeScalar(dst + i, src + i, n - i);
+  for (; i + 4 <= n; i += 4) {
+    __m256i gt = GreaterAvx2(src + i, dst + i);
+    __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+    __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),
+                        _mm256_blendv_epi8(d, s, gt));
+  }
+  MergeScalar(dst + i, src + i, n - i);
+  return true;
+}
+
+__attribute__((target("avx2"))) inline std::size_t DiffAvx2(
+    const uint64_t* a, const uint64_t* b, std::size_t n,
+    std::vector<std::size_t>& out) {
+  std::size_t count = 0;
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256i gt = GreaterAvx2(a + i, b + i);
+    int mask = _mm256_movemask_pd(_mm256_castsi256_pd(gt));
+    for (; mask != 0; mask &= mask - 1, ++count)
+      out.push_back(i + __builtin_ctz(mask));
+  }
+  std::size_t tail = DiffScalar(a + i, b + i, n - i, out);
+  for (std::size_t k = out.size() - tail; k < out.size(); ++k) out[k] += i;
+  return count + tail;
+}
+
+__attribute__((target("sse4.2"))) inline __m128i GreaterSse42(
+    const uint64_t* a, const uint64_t* b) {
+  const __m128i bias = _mm_set1_epi64x(INT64_MIN);
+  __m128i x = _mm_xor_si128(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(a)), bias);
+  __m128i y = _mm_xor_si128(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(b)), bias);
+  return _mm_cmpgt_epi64(x, y);
+}
+
+__attribute__((target("sse4.2"))) inline bool IsDominatedBySse42(
+    const uint64_t* a, const uint64_t* b, std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    __m128i gt = GreaterSse42(a + i, b + i);
+    if (!_mm_testz_si128(gt, gt)) return false;
+  }
+  return IsDominatedByScalar(a + i, b + i, n - i);
+}
+
+#endif  // VV_KERNELS_X86
+
+}  // namespace vv_detail
+
+// Best variant the CPU supports.
+inline VVIsa DetectVVIsa() {
+#ifdef VV_KERNELS_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) return VVIsa::kAvx2;
+  if (__builtin_cpu_supports("sse4.2")) return VVIsa::kSse42;
+#endif
+  return VVIsa::kScalar;
+}
+
+// Kernels of |isa|, which must be supported by the CPU.
+inline const VVKernels& GetVVKernels(VVIsa isa) {
+  static const VVKernels kScalar = {&vv_detail::IsDominatedByScalar,
+                                    &vv_detail::MergeScalar,
+                                    &vv_detail::DiffScalar};
+#ifdef VV_KERNELS_X86
+  // Two lanes win only for the dominance test; merge and diff stay scalar.
+  static const VVKernels kSse42 = {&vv_detail::IsDominatedBySse42,
+                                   &vv_detail::MergeScalar,
+                                   &vv_detail::DiffScalar};
+  static const VVKernels kAvx2 = {&vv_detail::IsDominatedByAvx2,
+                                  &vv_detail::MergeAvx2,
+                                  &vv_detail::DiffAvx2};
+  if (isa == VVIsa::kAvx2) return kAvx2;
+  if (isa == VVIsa::kSse42) return kSse42;
+#endif
+  return kScalar;
+}
+
+inline const VVKernels& GetVVKernels() {
+  static const VVKernels& kernels = GetVVKernels(DetectVVIsa());
+  return kernels;
+}
+
+// A version vector in one 32-byte aligned block, zero-padded to a whole
+// number of AVX2 lanes so the kernels never take their scalar tail.
+class PackedVV {
+ public:
+  static const std::size_t kAlignment = 32;
+  static const std::size_t kLanes = kAlignment / sizeof(uint64_t);
+
+  explicit PackedVV(std::size_t size = 0) { Resize(size); }
+
+  template <typename Container>
+  static PackedVV From(const Container& vv) {
+    PackedVV packed(vv.size());
+    for (std::size_t i = 0; i < vv.size(); ++i) packed.entries_[i] = vv[i];
+    return packed;
+  }
+
+  PackedVV(const PackedVV& other) : PackedVV(other.size_) {
+    std::memcpy(entries_, other.entries_, padded_ * sizeof(uint64_t));
+  }
+
+  PackedVV& operator=(PackedVV other) {
+    std::swap(entries_, other.entries_);
+    std::swap(size_, other.size_);
+    std::swap(padded_, other.padded_);
+    return *this;
+  }
+
+  ~PackedVV() { free(entries_); }
+
+  // New entries are zero.
+  void Resize(std::size_t size) {
+    std::size_t padded = (size + kLanes - 1) / kLanes * kLanes;
+    if (padded != padded_ || entries_ == nullptr) {
+      // An empty vector still gets one lane, so data() is never null.
+      std::size_t capacity = padded > 0 ? padded : padded + kLanes;
+      void* memory = nullptr;
+      if (posix_memalign(&memory, kAlignment, capacity * sizeof(uint64_t)) !=
+          0)
+        throw std::bad_alloc();
+      uint64_t* entries = static_cast<uint64_t*>(memory);
+      std::fill(entries, entries + capacity, 0);
+      if (entries_ != nullptr)
+        std::copy(entries_, entries_ + std::min(padded, padded_), entries);
+      free(entries_);
+      entries_ = entries;
+      padded_ = padded;
+    }
+    // Entries past the new size are part of the padding again.
+    std::fill(entries_ + std::min(size, size_), entries_ + padded_, 0);
+    size_ = size;
+  }
+
+  std::size_t size() const { return size_; }
+  uint64_t operator[](std::size_t i) const { return entries_[i]; }
+  uint64_t& operator[](std::size_t i) { return entries_[i]; }
+  const uint64_t* data() const { return entries_; }
+
+  bool IsDominatedBy(const PackedVV& other) const {
+    return size_ == other.size_ &&
+           GetVVKernels().is_dominated_by(entries_, other.entries_, padded_);
+  }
+
+  // Vectors of different sizes are merged over the longer one.
+  bool Merge(const PackedVV& other) {
+    if (other.size_ > size_) Resize(other.size_);
+    return GetVVKernels().merge(entries_, other.entries_, other.padded_);
+  }
+
+  // Entries past the end of |other| count as zero there.
+  std::size_t Diff(const PackedVV& other, std::vector<std::size_t>& out) const {
+    std::size_t n = std::min(padded_, other.padded_);
+    std::size_t count = GetVVKernels().diff(entries_, other.entries_, n, out);
+    for (std::size_t i = n; i < size_; ++i) {
+      if (entries_[i] > 0) {
+        out.push_back(i);
+        ++count;
+      }
+    }
+    return count;
+  }
+
+ private:
+  uint64_t* entries_ = nullptr;
+  std::size_t size_ = 0;
+  std::size_t padded_ = 0;
+};
+
+}  // namespace app
+}  // namespace vsync
+}  // namespace ndn
+
+#endif  // VV_KERNELS_HPP_
@@ -92,11 +92,368 @@ class Scenario (Processor):
         # any postprocessing, if any
         pass
 
+class LoggedSimulationJob (workerpool.Job):
+    "Job to simulate things, keeping the standard output in a file"
+    def __init__ (self, cmdline, output):
+        self.cmdline = cmdline
+        self.output = output
+    def run (self):
+        print (" ".join (self.cmdline) + " > " + self.output)
+        with open (self.output, "w") as f:
+            subprocess.call (self.cmdline, stdout=f)
+
+def parse_summary (output):
+    "Collect the 'Some metric is: value' lines a scenario prints at the end"
+    summary = {}
+    with open (output) as f:
+        for line in f:
+            if " is: " not in line:
+                continue
+            key, value = line.split (" is: ", 1)
+            summary[key] = value.split ()[0]
+    return summary
+
+class HeartbeatSweep (Processor):
+    "hub-and-spoke sync interest bytes and delay, fixed against adaptive heartbeat with the same seed"
+    max_multiples = [2, 4, 8, 16]
+
+    def __init__ (self, name):
+        self.name = name
+
+    def output (self, max_multiple):
+        return "results/heartbeat/AHB%s.txt" % max_multiple
+
+    def simulate (self):
+        if not os.path.exists ("results/heartbeat"):
+            os.makedirs ("results/heartbeat")
+        for max_multiple in [0] + self.max_multiples:
+            cmdline = ["./build/hub-and-spoke", "--RngRun=1"]
+            if max_multiple > 0:
+                cmdline += ["--HeartbeatMode=adaptive",
+                            "--HBMaxMultiple=%s" % max_multiple]
+            pool.put (LoggedSimulationJob (cmdline, self.output (max_multiple)))
+
+    def postprocess (self):
+        with open ("results/heartbeat-sweep.txt", "w") as f:
+            f.write ("HBMaxMultiple\tSyncBytes\tBytesSaved\tDelay\tAddedDelay\n")
+            fixed = parse_summary (self.output (0))
+            fixed_bytes = float (fixed.get ("Sync interest bytes", "nan"))
+            fixed_delay = float (fixed.get ("Average message delivery delay", "nan"))
+            for max_multiple in [0] + self.max_multiples:
+                summary = parse_summary (self.output (max_multiple))
+                sync_bytes = float (summary.get ("Sync interest bytes", "nan"))
+                delay = float (summary.get ("Average message delivery delay", "nan"))
+                f.write ("%s\t%s\t%s\t%s\t%s\n" % (
+                    max_multiple or "fixed", sync_bytes,
+                    fixed_bytes - sync_bytes, delay, delay - fixed_delay))
+
+class CoalescingSweep (Processor):
+    "hub-and-spoke over DataRate, per-message publishing against coalescing"
+    data_rates = [1, 2, 5, 10, 20]
+    windows = [0, 20, 100]
+
+    def __init__ (self, name):
+        self.name = name
+
+    def output (self, data_rate, window):
+        return "results/coalescing/DR%sCW%s.txt" % (data_rate, window)
+
+    def simulate (self):
+        if not os.path.exists ("results/coalescing"):
+            os.makedirs ("results/coalescing")
+        for data_rate in self.data_rates:
+            for window in self.windows:
+                cmdline = ["./build/hub-and-spoke",
+                           "--DataRate=%s" % data_rate,
+                           "--CoalesceWindowMS=%s" % window]
+                pool.put (LoggedSimulationJob (cmdline, self.output (data_rate, window)))
+
+    def postprocess (self):
+        with open ("results/coalescing-sweep.txt", "w") as f:
+            f.write ("DataRate\tWindowMS\tMessagesPerSecond\tBytesPerMessage\tDelay\tAddedDelay\n")
+            for data_rate in self.data_rates:
+                baseline = None
+                for window in self.windows:
+                    summary = parse_summary (self.output (data_rate, window))
+                    delay = float (summary.get ("Average message delivery delay", "nan"))
+                    if baseline is None:
+                        baseline = delay
+                    f.write ("%s\t%s\t%s\t%s\t%s\t%s\n" % (
+                        data_rate, window,
+                        summary.get ("Messages delivered per second", "NA"),
+                        summary.get ("Bytes per delivered message", "NA"),
+                        delay, delay - baseline))
+
+class WifiSweep (Processor):
+    "wifi-adhoc over node density and speed"
+    densities = [10, 20, 40]
+    speeds = [0, 5, 20]
+    metrics = ["Average data propagation delay", "Delivery ratio",
+               "Sync airtime", "Data airtime"]
+
+    def __init__ (self, name):
+        self.name = name
+
+    def output (self, nodes, speed):
+        return "results/wifi/N%sS%s.txt" % (nodes, speed)
+
+    def simulate (self):
+        if not os.path.exists ("results/wifi"):
+            os.makedirs ("results/wifi")
+        for nodes in self.densities:
+            for speed in self.speeds:
+                cmdline = ["./build/wifi-adhoc",
+                           "--NumOfNodes=%s" % nodes,
+                           "--MaxSpeed=%s" % speed]
+                pool.put (LoggedSimulationJob (cmdline, self.output (nodes, speed)))
+
+    def postprocess (self):
+        with open ("results/wifi-sweep.txt", "w") as f:
+            f.write ("Nodes\tMaxSpeed\tSyncDelay\tDeliveryRatio\tSyncAirtime\tDataAirtime\n")
+            for nodes in self.densities:
+                for speed in self.speeds:
+                    summary = parse_summary (self.output (nodes, speed))
+                    f.write ("\t".join ([str (nodes), str (speed)] +
+                                        [summary.get (m, "NA") for m in self.metrics]) + "\n")
+
+    def graph (self):
+        pass
+
+class LoadScalingSweep (Processor):
+    "load-generator throughput over the number of shards, with skewed publishers"
+    nodes = 2000
+    balances = ["weighted", "round-robin"]
+    metrics = ["Messages delivered per second", "CPU time per delivered message",
+               "Memory per node at end", "Packets dropped on full rings"]
+
+    def __init__ (self, name):
+        self.name = name
+        self.shards = [1]
+        while self.shards[-1] * 2 <= multiprocessing.cpu_count ():
+            self.shards.append (self.shards[-1] * 2)
+
+    def output (self, shards, balance):
+        return "results/load-scaling/K%s-%s.txt" % (shards, balance)
+
+    def simulate (self):
+        if not os.path.exists ("results/load-scaling"):
+            os.makedirs ("results/load-scaling")
+        # Every run uses all the cores it is given, so run them one by one
+        for shards in self.shards:
+            for balance in self.balances:
+                cmdline = ["./build/load-generator",
+                           "--NumOfNodes=%s" % self.nodes,
+                           "--HotFraction=0.05",
+                           "--Shards=%s" % shards,
+                           "--Balance=%s" % balance]
+                LoggedSimulationJob (cmdline, self.output (shards, balance)).run ()
+
+    def postprocess (self):
+        with open ("results/load-scaling.txt", "w") as f:
+            f.write ("Shards\tBalance\tMessagesPerSec\tCpuPerMessageUS\tMemPerNodeKB\tRingDrops\n")
+            for shards in self.shards:
+                for balance in self.balances:
+                    summary = parse_summary (self.output (shards, balance))
+                    f.write ("\t".join ([str (shards), balance] +
+                                        [summary.get (m, "NA") for m in self.metrics]) + "\n")
+
+    def graph (self):
+        pass
+
+class ObjectSweep (Processor):
+    "hub-and-spoke with large objects, manifest and fetch against one sync update per segment"
+    sizes = [16384, 65536, 262144, 1048576]
+    modes = [("manifest", 4), ("manifest", 16), ("versions", 0)]
+    metrics = ["Average object completion latency", "Max object completion latency",
+               "Object goodput", "Total number of objects received"]
+
+    def __init__ (self, name):
+        self.name = name
+
+    def output (self, size, mode, window):
+        return "results/objects/OS%s-%s%s.txt" % (size, mode, window)
+
+    def simulate (self):
+        if not os.path.exists ("results/objects"):
+            os.makedirs ("results/objects")
+        for size in self.sizes:
+            for mode, window in self.modes:
+                cmdline = ["./build/hub-and-spoke",
+                           "--ns3::PointToPointNetDevice::DataRate=100Mbps",
+                           "--DataRate=0.2",
+                           "--ObjectSize=%s" % size,
+                           "--ObjectMode=%s" % mode]
+                if window > 0:
+                    cmdline.append ("--PipelineWindow=%s" % window)
+                pool.put (LoggedSimulationJob (cmdline, self.output (size, mode, window)))
+
+    def postprocess (self):
+        with open ("results/object-sweep.txt", "w") as f:
+            f.write ("ObjectSize\tMode\tWindow\tLatency\tMaxLatency\tGoodput\tReceived\n")
+            for size in self.sizes:
+                for mode, window in self.modes:
+                    summary = parse_summary (self.output (size, mode, window))
+                    f.write ("\t".join ([str (size), mode, str (window)] +
+                                        [summary.get (m, "NA") for m in self.metrics]) + "\n")
+
+    def graph (self):
+        pass
+
+class JoinSweep (Processor):
+    "view-change joiners over history length, with and without a snapshot, and with members leaving at the same time"
+    join_times = [20, 40, 80, 160]
+    horizons = [0, 10000]
+    leaving = [0, 2]
+    metrics = ["History length", "Average time to fully synced",
+               "Max time to fully synced", "Joiners not fully synced"]
+
+    def __init__ (self, name):
+        self.name = name
+
+    def output (self, join_time, horizon, leaving):
+        return "results/join/J%sH%sL%s.txt" % (join_time, horizon, leaving)
+
+    def simulate (self):
+        if not os.path.exists ("results/join"):
+            os.makedirs ("results/join")
+        for join_time in self.join_times:
+            for horizon in self.horizons:
+                for leaving in self.leaving:
+                    cmdline = ["./build/view-change",
+                               "--JoiningNodes=2",
+                               "--LeavingNodes=%s" % leaving,
+                               "--JoinTimeSeconds=%s" % join_time,
+                               "--TotalRunTimeSeconds=%s" % (join_time + 60),
+                               "--MaxDataCount=100000",
+                               "--SnapshotHorizon=%s" % horizon]
+                    pool.put (LoggedSimulationJob (cmdline, self.output (join_time, horizon, leaving)))
+
+    def postprocess (self):
+        with open ("results/join-sweep.txt", "w") as f:
+            f.write ("JoinTime\tHorizon\tLeaving\tHistory\tSyncTime\tMaxSyncTime\tNotSynced\n")
+            for join_time in self.join_times:
+                for horizon in self.horizons:
+                    for leaving in self.leaving:
+                        summary = parse_summary (self.output (join_time, horizon, leaving))
+                        f.write ("\t".join ([str (join_time), str (horizon), str (leaving)] +
+                                            [summary.get (m, "NA") for m in self.metrics]) + "\n")
+
+    def graph (self):
+        pass
+
+class VVEncodingSweep (Processor):
+    "hub-and-spoke sync interest size over group size, library against compact version vector encodings"
+    group_sizes = [10, 50, 100, 200, 400, 800]
+    metrics = ["Bytes per sync interest", "Compact bytes per sync interest",
+               "Incremental bytes per sync interest", "Sync overhead bytes",
+               "Compact sync overhead bytes", "Incremental sync overhead bytes"]
+
+    def __init__ (self, name):
+        self.name = name
+
+    def output (self, nodes):
+        return "results/vv-encoding/N%s.txt" % nodes
+
+    def simulate (self):
+        if not os.path.exists ("results/vv-encoding"):
+            os.makedirs ("results/vv-encoding")
+        for nodes in self.group_sizes:
+            cmdline = ["./build/hub-and-spoke",
+                       "--NumOfNodes=%s" % nodes,
+                       "--MeasureVVEncoding=1"]
+            pool.put (LoggedSimulationJob (cmdline, self.output (nodes)))
+
+    def postprocess (self):
+        with open ("results/vv-encoding-sweep.txt", "w") as f:
+            f.write ("Nodes\tBytes\tCompactBytes\tIncrementalBytes\tOverhead\tCompactOverhead\tIncrementalOverhead\n")
+            for nodes in self.group_sizes:
+                summary = parse_summary (self.output (nodes))
+                f.write ("\t".join ([str (nodes)] +
+                                    [summary.get (m, "NA") for m in self.metrics]) + "\n")
+
+    def graph (self):
+        pass
+
+class HierarchicalSweep (Processor):
+    "hierarchical scenario over group size, flat VectorSync against two-level sync"
+    group_sizes = [100, 400, 1000, 2000, 4000]
+    modes = ["flat", "hierarchical"]
+    metrics = ["Average message delivery delay", "Max message sync delay",
+               "Message delivery ratio", "Sync interest bytes", "Total bytes",
+               "Bytes per delivered message", "Relay transfer bytes",
+               "Simulation wall time"]
+
+    def __init__ (self, name):
+        self.name = name
+
+    def output (self, nodes, mode):
+        return "results/hierarchical/%sN%s.txt" % (mode, nodes)
+
+    def simulate (self):
+        if not os.path.exists ("results/hierarchical"):
+            os.makedirs ("results/hierarchical")
+        for nodes in self.group_sizes:
+            for mode in self.modes:
+                cmdline = ["./build/hierarchical",
+                           "--NumOfNodes=%s" % nodes,
+                           "--Mode=%s" % mode]
+                pool.put (LoggedSimulationJob (cmdline, self.output (nodes, mode)))
+
+    def postprocess (self):
+        with open ("results/hierarchical-sweep.txt", "w") as f:
+            f.write ("Nodes\tMode\tDelay\tMaxDelay\tDeliveryRatio\tSyncBytes\tTotalBytes\tBytesPerMessage\tRelayBytes\tWallTime\n")
+            for nodes in self.group_sizes:
+                for mode in self.modes:
+                    summary = parse_summary (self.output (nodes, mode))
+                    f.write ("\t".join ([str (nodes), mode] +
+                                        [summary.get (m, "NA") for m in self.metrics]) + "\n")
+
+    def graph (self):
+        pass
+
+class DelayCdf (Processor):
+    "Delay percentiles and CDFs of all runs in results/, by tools/postprocess"
+    def __init__ (self, name):
+        self.name = name
+
+    def simulate (self):
+        pass
+
+    def postprocess (self):
+        subprocess.call (["./build/postprocess", "--Output=results/summary", "results"])
+
 try:
     # Simulation, processing, and graph building
     fig = Scenario (name="NAME_TO_CONFIGURE")
     fig.run ()
 
+    fig = HeartbeatSweep (name="heartbeat")
+    fig.run ()
+
+    fig = CoalescingSweep (name="coalescing")
+    fig.run ()
+
+    fig = WifiSweep (name="wifi")
+    fig.run ()
+
+    fig = LoadScalingSweep (name="load-scaling")
+    fig.run ()
+
+    fig = ObjectSweep (name="objects")
+    fig.run ()
+
+    fig = JoinSweep (name="join")
+    fig.run ()
+
+    fig = VVEncodingSweep (name="vv-encoding")
+    fig.run ()
+
+    fig = HierarchicalSweep (name="hierarchical")
+    fig.run ()
+
+    fig = DelayCdf (name="delay-cdf")
+    fig.run ()
+
 finally:
     pool.join ()
     pool.shutdown ()
@@ -16,6 +16,10 @@
 #include "ns3/point-to-point-module.h"
 #include "ns3/random-variable-stream.h"
 
+#include "event-log.hpp"
+#include "forwarder-pressure-tracer.hpp"
+#include "queue-monitor.hpp"
+
 NS_LOG_COMPONENT_DEFINE("ns3.ndn.vsync.scenarios.Campus");
 
 namespace ns3 {
@@ -27,6 +31,7 @@ std::unordered_map<std::string, std::pair<double, std::vector<double>>> delays;
 static void DataEvent(std::string nid, std::shared_ptr<const ndn::Data> data,
                       bool is_local) {
   auto name = data->getName().toUri();
+  ndn::vsync::EventLog::DataEvent(nid, name, is_local);
   /*
   NS_LOG_INFO("new_data_name=" << name << ", node_id=" << nid << ", is_local="
                                << (is_local ? "true" : "false"));
@@ -48,6 +53,7 @@ std::map<::ndn::vsync::ViewID, std::pair<double, std::vector<double>>,
 
 static void ViewChange(std::string nid, const ::ndn::vsync::ViewID& vid,
                        const ::ndn::vsync::ViewInfo& vinfo, bool is_leader) {
+  ndn::vsync::EventLog::ViewChange(nid, vid, vinfo, is_leader);
   NS_LOG_INFO("node_id=\"" << nid << "\", is_leader=" << (is_leader ? 'Y' : 'N')
                            << ", view_id=" << vid << ", view_info=" << vinfo);
 
@@ -60,7 +66,13 @@ static void ViewChange(std::string nid, const ::ndn::vsync::ViewID& vid,
     entry.second.push_back(now);
 }
 
+static void VectorChange(std::string nid, std::size_t idx,
+                         const ::ndn::vsync::VersionVector& vv) {
+  ndn::vsync::EventLog::VectorChange(nid, idx, vv);
+}
+
 static void NodeStop(std::string nid) {
+  ndn::vsync::EventLog::NodeStop(nid);
   NS_LOG_INFO("node /" << nid << " stops");
 }
 
@@ -72,6 +84,9 @@ int main(int argc, char* argv[]) {
   bool Synchronized = false;
   double DataRate = 1.0;
   int LeavingNodes = 0;
+  double CsPitSamplePeriod = 0.0;
+  bool BinaryEventLog = false;
+  double QueueSamplePeriod = 0.0;
 
   ::ndn::vsync::SetInterestLifetime(ndn::time::milliseconds(100),
                                     ndn::time::milliseconds(100));
@@ -90,6 +105,16 @@ int main(int argc, char* argv[]) {
                LeavingNodes);
   cmd.AddValue("DataRate", "Data publishing rate (packets per second)",
                DataRate);
+  cmd.AddValue("CsPitSamplePeriod",
+               "CS and PIT sampling period in seconds (default 0, disabled)",
+               CsPitSamplePeriod);
+  cmd.AddValue("BinaryEventLog",
+               "If set, log sync events to <result file>-events.bin",
+               BinaryEventLog);
+  cmd.AddValue("QueueSamplePeriod",
+               "Link queue sampling period in seconds (0 to disable the "
+               "queue monitor)",
+               QueueSamplePeriod);
   cmd.Parse(argc, argv);
 
   ::ndn::vsync::SetHeartbeatInterval(
@@ -111,10 +136,6 @@ int main(int argc, char* argv[]) {
   ndn::StrategyChoiceHelper::InstallAll(::ndn::vsync::kSyncPrefix,
                                         "/localhost/nfd/strategy/multicast");
 
-  Ptr<UniformRandomVariable> seed = CreateObject<UniformRandomVariable>();
-  seed->SetAttribute("Min", DoubleValue(0.0));
-  seed->SetAttribute("Max", DoubleValue(1000.0));
-
   Ptr<UniformRandomVariable> stop_time = CreateObject<UniformRandomVariable>();
   stop_time->SetAttribute("Min", DoubleValue(10.0));
   stop_time->SetAttribute("Max", DoubleValue(TotalRunTimeSeconds));
@@ -157,7 +178,7 @@ int main(int argc, char* argv[]) {
     }
     helper.SetAttribute("DataRate", DoubleValue(DataRate));
     if (!Synchronized)
-      helper.SetAttribute("RandomSeed", UintegerValue(seed->GetInteger()));
+      helper.SetAttribute("NodeIndex", UintegerValue(i));
     helper.Install(node);
 
     ndnGlobalRoutingHelper.AddOrigins('/' + nid, node);
@@ -168,6 +189,9 @@ int main(int argc, char* argv[]) {
 
     node->GetApplication(0)->TraceConnect("ViewChange", nid,
                                           MakeCallback(&ViewChange));
+    if (BinaryEventLog)
+      node->GetApplication(0)->TraceConnect("VectorChange", nid,
+                                            MakeCallback(&VectorChange));
   }
 
   ndn::GlobalRoutingHelper::CalculateRoutes();
@@ -186,11 +210,25 @@ int main(int argc, char* argv[]) {
   if (LossRate > 0.0) file_name += "LR" + std::to_string(LossRate);
   if (DataRate != 1.0) file_name += "DR" + std::to_string(DataRate);
   if (LeavingNodes > 0) file_name += "LN" + std::to_string(LeavingNodes);
+  if (RngSeedManager::GetRun() != 1)
+    file_name += "Run" + std::to_string(RngSeedManager::GetRun());
 
   ndn::L3RateTracer::InstallAll(file_name + "-rate-trace.txt",
                                 Seconds(TotalRunTimeSeconds - 0.1));
 
+  if (CsPitSamplePeriod > 0.0)
+    ndn::vsync::ForwarderPressureTracer::InstallAll(
+        file_name + "-cs-pit-trace.txt", Seconds(CsPitSamplePeriod));
+
+  if (BinaryEventLog)
+    ndn::vsync::EventLog::Open(file_name + "-events.bin");
+
+  ndn::vsync::QueueMonitor queue_monitor(Seconds(QueueSamplePeriod));
+  if (QueueSamplePeriod > 0.0) queue_monitor.InstallAll();
+
   Simulator::Run();
+  ndn::vsync::EventLog::Close();
+  if (QueueSamplePeriod > 0.0) queue_monitor.Report(file_name + "-queue.txt");
   Simulator::Destroy();
 
   std::fstream fs(file_name, std::ios_base::out | std::ios_base::trunc);
@@ -0,0 +1,377 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/ndnSIM-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/random-variable-stream.h"
+
+#include "forwarder-pressure-tracer.hpp"
+#include "quiescence-monitor.hpp"
+#include "scenario-config.hpp"
+#include "steady-state.hpp"
+#include "sync-aggregation-strategy.hpp"
+#include "sync-metrics.hpp"
+#include "traffic-counter.hpp"
+
+NS_LOG_COMPONENT_DEFINE("ns3.ndn.vsync.scenarios.Engine");
+
+namespace ns3 {
+
+using ndn::vsync::ScenarioConfig;
+
+// One sync group member: the simulated node it runs on and its NodeID.
+struct Member {
+  Ptr<Node> node;
+  std::string nid;
+};
+
+static void NodeStop(std::string nid) {
+  NS_LOG_INFO("node " << nid << " stops");
+}
+
+static bool AppHasAttribute(const std::string& app, const std::string& attr) {
+  TypeId::AttributeInformation info;
+  return TypeId::LookupByName(app).LookupAttributeByName(attr, &info);
+}
+
+// Builds the topology described by |config| and returns the sync group
+// members placed on it. For hub-and-spoke, |hub| receives the central node.
+static std::vector<Member> BuildTopology(const ScenarioConfig& config,
+                                         const std::string& topology,
+                                         Ptr<RateErrorModel> rem,
+                                         NodeContainer& hub) {
+  std::vector<Member> members;
+  int N = config.GetInt("NumOfNodes", 10);
+
+  if (topology == "hub-and-spoke") {
+    NodeContainer nodes;
+    nodes.Create(N + 1);
+    hub.Add(nodes.Get(0));
+
+    // Node 0 is central hub
+    PointToPointHelper p2p;
+    for (int i = 1; i <= N; ++i) {
+      p2p.Install(nodes.Get(0), nodes.Get(i));
+      nodes.Get(i)->GetDevice(0)->SetAttribute("ReceiveErrorModel",
+                                               PointerValue(rem));
+      members.push_back({nodes.Get(i), "/N" + std::to_string(i)});
+    }
+  } else if (topology == "line") {
+    if (N < 2) throw std::invalid_argument("Line needs at least 2 nodes");
+    NodeContainer nodes;
+    nodes.Create(N);
+
+    PointToPointHelper p2p;
+    for (int i = 0; i < N - 1; ++i) {
+      p2p.Install(nodes.Get(i), nodes.Get(i + 1));
+      nodes.Get(i)->GetDevice(nodes.Get(i)->GetNDevices() - 1)
+          ->SetAttribute("ReceiveErrorModel", PointerValue(rem));
+      nodes.Get(i + 1)->GetDevice(nodes.Get(i + 1)->GetNDevices() - 1)
+          ->SetAttribute("ReceiveErrorModel", PointerValue(rem));
+    }
+    for (int i = 0; i < N; ++i)
+      members.push_back({nodes.Get(i), "/N" + std::to_string(i)});
+  } else if (topology.compare(0, 10, "annotated:") == 0) {
+    AnnotatedTopologyReader topologyReader("", 25);
+    topologyReader.SetFileName(topology.substr(10));
+    topologyReader.Read();
+
+    Config::Set(
+        "/NodeList/*/DeviceList/*/$ns3::PointToPointNetDevice/"
+        "ReceiveErrorModel",
+        PointerValue(rem));
+
+    for (const auto& name : config.GetList("Members")) {
+      Ptr<Node> node = Names::Find<Node>(name);
+      if (node == nullptr)
+        throw std::invalid_argument("Unknown member router " + name);
+      members.push_back({node, '/' + name});
+    }
+  } else {
+    throw std::invalid_argument("Unknown topology " + topology);
+  }
+
+  return members;
+}
+
+static void InstallStaticRoutes(const std::string& topology,
+                                const NodeContainer& hub,
+                                const std::vector<Member>& members) {
+  if (topology == "hub-and-spoke") {
+    for (const auto& m : members) {
+      ndn::FibHelper::AddRoute(hub.Get(0), ::ndn::vsync::kSyncPrefix, m.node,
+                               1);
+      ndn::FibHelper::AddRoute(hub.Get(0), m.nid, m.node, 1);
+
+      ndn::FibHelper::AddRoute(m.node, "/", hub.Get(0), 1);
+      ndn::FibHelper::AddRoute(m.node, ::ndn::vsync::kSyncPrefix, hub.Get(0),
+                               1);
+    }
+  } else if (topology == "line") {
+    // Data prefixes follow global routing; sync interests are flooded hop by
+    // hop along the line.
+    for (std::size_t i = 0; i < members.size(); ++i) {
+      if (i > 0)
+        ndn::FibHelper::AddRoute(members[i].node, ::ndn::vsync::kSyncPrefix,
+                                 members[i - 1].node, 1);
+      if (i + 1 < members.size())
+        ndn::FibHelper::AddRoute(members[i].node, ::ndn::vsync::kSyncPrefix,
+                                 members[i + 1].node, 1);
+    }
+  }
+}
+
+static int Run(const ScenarioConfig& config) {
+  const std::string topology = config.GetString("Topology", "hub-and-spoke");
+  const std::string app_type =
+      config.GetString("App", "ns3::ndn::vsync::SimpleNodeApp");
+  const double TotalRunTimeSeconds =
+      config.GetDouble("TotalRunTimeSeconds", 100.0);
+  const double StartTimeSeconds = config.GetDouble("StartTimeSeconds", 1.0);
+  const bool Synchronized = config.GetBool("Synchronized", false);
+  const double LossRate = config.GetDouble("LossRate", 0.0);
+  const int LinkDelayMS = config.GetInt("LinkDelayMS", 10);
+  const int LeavingNodes = config.GetInt("LeavingNodes", 0);
+  const double LeaveAfterSeconds = config.GetDouble("LeaveAfterSeconds", 10.0);
+  const double DataRate = config.GetDouble("DataRate", 1.0);
+  const std::string SyncStrategy =
+      config.GetString("SyncStrategy", "multicast");
+
+  std::vector<std::string> metric_list = config.GetList("Metrics");
+  std::set<std::string> metrics(metric_list.begin(), metric_list.end());
+  if (!config.Has("Metrics"))
+    metrics = {"sync-delay", "prop-delay", "rate-trace", "view-change"};
+
+  Config::SetDefault("ns3::PointToPointNetDevice::DataRate",
+                     StringValue(config.GetString("LinkDataRate", "100Mbps")));
+  Config::SetDefault(
+      "ns3::DropTailQueue::MaxPackets",
+      StringValue(config.GetString("QueueMaxPackets", "100")));
+  Config::SetDefault("ns3::PointToPointChannel::Delay",
+                     TimeValue(MilliSeconds(LinkDelayMS)));
+  Config::SetDefault("ns3::RateErrorModel::ErrorUnit",
+                     StringValue("ERROR_UNIT_PACKET"));
+
+  // Interest lifetimes default to a multiple of the link delay; heartbeats
+  // default to a multiple of the data interval.
+  int lifetime_multiple = config.GetInt("LifetimeMultiple", 5);
+  int sync_lifetime =
+      config.GetInt("SyncInterestLifetimeMS", lifetime_multiple * LinkDelayMS);
+  int data_lifetime =
+      config.GetInt("DataInterestLifetimeMS", lifetime_multiple * LinkDelayMS);
+  ::ndn::vsync::SetInterestLifetime(ndn::time::milliseconds(sync_lifetime),
+                                    ndn::time::milliseconds(data_lifetime));
+
+  int hb_interval = config.GetInt(
+      "HeartbeatIntervalMS", config.GetInt("HBMultiple", 1) *
+                                 static_cast<int>(1000.0 / DataRate));
+  ::ndn::vsync::SetHeartbeatInterval(ndn::time::milliseconds(hb_interval));
+
+  Ptr<RateErrorModel> rem = CreateObject<RateErrorModel>();
+  rem->SetAttribute("ErrorRate", DoubleValue(LossRate));
+  rem->SetAttribute("ErrorUnit", StringValue("ERROR_UNIT_PACKET"));
+
+  NodeContainer hub;
+  std::vector<Member> members = BuildTopology(config, topology, rem, hub);
+  if (members.empty()) throw std::invalid_argument("No sync group members");
+  const int N = members.size();
+
+  ndn::StackHelper ndnHelper;
+  ndnHelper.setCsSize(config.GetInt("CsSize", 1000));
+  ndnHelper.InstallAll();
+
+  ndn::StrategyChoiceHelper::InstallAll(::ndn::vsync::kSyncPrefix,
+                                        "/localhost/nfd/strategy/multicast");
+  if (SyncStrategy == "aggregation") {
+    nfd::fw::SyncAggregationStrategy::SetAggregationWindow(
+        ndn::time::milliseconds(config.GetInt("AggregationWindowMS", 5)));
+    NodeContainer aggregators;
+    if (hub.GetN() > 0)
+      aggregators = hub;
+    else
+      aggregators = NodeContainer::GetGlobal();
+    ndn::StrategyChoiceHelper::Install<nfd::fw::SyncAggregationStrategy>(
+        aggregators, ::ndn::vsync::kSyncPrefix);
+  } else if (SyncStrategy != "multicast") {
+    throw std::invalid_argument("Unknown sync strategy " + SyncStrategy);
+  }
+
+  // The line always routes data prefixes globally, like line.cpp does.
+  bool annotated = topology.compare(0, 10, "annotated:") == 0;
+  std::string routing =
+      config.GetString("Routing", annotated ? "global" : "static");
+  bool global_routing = routing == "global" || topology == "line";
+  ndn::GlobalRoutingHelper ndnGlobalRoutingHelper;
+  if (global_routing) ndnGlobalRoutingHelper.InstallAll();
+
+  Ptr<UniformRandomVariable> stop_time = CreateObject<UniformRandomVariable>();
+  stop_time->SetAttribute("Min", DoubleValue(LeaveAfterSeconds));
+  stop_time->SetAttribute("Max", DoubleValue(TotalRunTimeSeconds));
+
+  std::string vinfo_proto;
+  if (config.GetBool("ViewInfo", true) &&
+      AppHasAttribute(app_type, "ViewInfo")) {
+    std::vector<::ndn::vsync::MemberInfo> mlist;
+    for (const auto& m : members) mlist.push_back({::ndn::Name(m.nid)});
+    ::ndn::vsync::ViewInfo vinfo(mlist);
+    vinfo.Encode(vinfo_proto);
+  }
+
+  auto app_attributes = config.GetWithPrefix("App.");
+  ndn::vsync::SyncMetrics sync_metrics(N);
+
+  // A requested confidence interval width implies warm-up detection.
+  const double CIWidth = config.GetDouble("CIWidth", 0.0);
+  ndn::vsync::SteadyStateDetector steady_state;
+  bool steady_state_enabled =
+      config.GetBool("WarmupDetection", false) || CIWidth > 0.0;
+  if (steady_state_enabled)
+    sync_metrics.SetSteadyStateDetector(&steady_state);
+  if (CIWidth > 0.0)
+    steady_state.EnableEarlyStop(
+        CIWidth, Seconds(config.GetDouble("CICheckPeriod", 5.0)),
+        config.GetInt("CIMinSamples", 200));
+
+  const bool StopWhenQuiescent = config.GetBool("StopWhenQuiescent", false);
+  ndn::vsync::QuiescenceMonitor quiescence(
+      Seconds(config.GetDouble("QuiescenceGraceSeconds", 1.0)));
+
+  for (int i = 0; i < N; ++i) {
+    const Member& m = members[i];
+    ndn::AppHelper helper(app_type);
+    helper.SetAttribute("NodeID", StringValue(m.nid));
+    if (!vinfo_proto.empty())
+      helper.SetAttribute("ViewInfo", StringValue(vinfo_proto));
+    if (!Synchronized)
+      helper.SetAttribute("NodeIndex", UintegerValue(i));
+    if (AppHasAttribute(app_type, "DataRate"))
+      helper.SetAttribute("DataRate", DoubleValue(DataRate));
+    for (const auto& attr : app_attributes)
+      helper.SetAttribute(attr.first, StringValue(attr.second));
+    helper.SetAttribute("StartTime", TimeValue(Seconds(StartTimeSeconds)));
+    if (i < LeavingNodes) {
+      double st = stop_time->GetValue();
+      sync_metrics.AddDeparture(st);
+      std::cout << "node " << m.nid << " leaves at " << st << std::endl;
+      Simulator::Schedule(Seconds(st), NodeStop, m.nid);
+      quiescence.AddDeparture(m.nid, Seconds(st));
+      helper.SetAttribute("StopTime", TimeValue(Seconds(st)));
+    } else {
+      helper.SetAttribute("StopTime", TimeValue(Seconds(TotalRunTimeSeconds)));
+    }
+    helper.Install(m.node);
+
+    if (global_routing) {
+      ndnGlobalRoutingHelper.AddOrigins(m.nid, m.node);
+      if (annotated)
+        ndnGlobalRoutingHelper.AddOrigins(::ndn::vsync::kSyncPrefix.toUri(),
+                                          m.node);
+    }
+
+    Ptr<Application> app =
+        m.node->GetApplication(m.node->GetNApplications() - 1);
+    sync_metrics.Connect(app, m.nid);
+    if (StopWhenQuiescent) quiescence.Connect(app, m.nid);
+  }
+
+  if (global_routing) ndn::GlobalRoutingHelper::CalculateRoutes();
+  InstallStaticRoutes(topology, hub, members);
+
+  Simulator::Stop(Seconds(TotalRunTimeSeconds));
+
+  std::string file_name = config.GetString("Output", "results/engine");
+  if (RngSeedManager::GetRun() != 1)
+    file_name += "Run" + std::to_string(RngSeedManager::GetRun());
+
+  if (metrics.count("rate-trace"))
+    ndn::L3RateTracer::InstallAll(file_name + "-rate-trace.txt",
+                                  StopWhenQuiescent
+                                      ? Seconds(1.0)
+                                      : Seconds(TotalRunTimeSeconds - 0.1));
+  if (metrics.count("cs-pit"))
+    ndn::vsync::ForwarderPressureTracer::InstallAll(
+        file_name + "-cs-pit-trace.txt",
+        Seconds(config.GetDouble("CsPitSamplePeriod", 1.0)));
+  if (metrics.count("traffic")) ndn::vsync::TrafficCounter::InstallAll();
+
+  // Every key has been read by now; one that was not is misspelled or does
+  // not apply to this scenario, and would otherwise run with the default.
+  std::vector<std::string> unused = config.GetUnusedKeys();
+  if (!unused.empty()) {
+    std::string keys;
+    for (const auto& key : unused) keys += (keys.empty() ? "" : ", ") + key;
+    throw std::invalid_argument("Unused config keys: " + keys);
+  }
+
+  Simulator::Run();
+  Simulator::Destroy();
+
+  sync_metrics.ReportDataDelays(file_name, metrics.count("sync-delay") > 0,
+                                metrics.count("prop-delay") > 0);
+  if (steady_state_enabled) steady_state.Report();
+  if (StopWhenQuiescent) quiescence.Report(Seconds(TotalRunTimeSeconds));
+
+  if (metrics.count("traffic") && sync_metrics.GetDeliveredCount() > 0) {
+    using ndn::vsync::TrafficCounter;
+    std::cout << "Sync interest bytes per delivered data is: "
+              << static_cast<double>(
+                     TrafficCounter::GetBytes(TrafficCounter::kSyncInterest)) /
+                     sync_metrics.GetDeliveredCount()
+              << std::endl;
+    std::cout << "Total bytes per delivered data is: "
+              << static_cast<double>(TrafficCounter::GetTotalBytes()) /
+                     sync_metrics.GetDeliveredCount()
+              << std::endl;
+  }
+
+  if (metrics.count("view-change")) sync_metrics.ReportViewChangeDelays();
+
+  return 0;
+}
+
+int main(int argc, char* argv[]) {
+  std::string ConfigFile;
+  std::string Overrides;
+
+  CommandLine cmd;
+  cmd.AddValue("Config", "Scenario description file (see configs/)",
+               ConfigFile);
+  cmd.AddValue("Set", "Overrides of the form \"Key=value;Key=value\"",
+               Overrides);
+  cmd.Parse(argc, argv);
+
+  try {
+    ScenarioConfig config;
+    if (!ConfigFile.empty()) config.Load(ConfigFile);
+    config.ApplyOverrides(Overrides);
+
+    // Runs of one sweep share the config; keep their outputs apart.
+    if (!Overrides.empty()) {
+      std::string suffix = Overrides;
+      std::replace_if(suffix.begin(), suffix.end(),
+                      [](char c) { return !std::isalnum(c) && c != '.'; },
+                      '_');
+      config.Set("Output",
+                 config.GetString("Output", "results/engine") + "-" + suffix);
+    }
+
+    return Run(config);
+  } catch (const std::invalid_argument& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    return -1;
+  }
+}
+
+}  // namespace ns3
+
+int main(int argc, char* argv[]) { return ns3::main(argc, argv); }
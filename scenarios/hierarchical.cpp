@@ -0,0 +1,306 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#include "simple-app.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/ndnSIM-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+
+#include "representative-relay.hpp"
+#include "traffic-counter.hpp"
+
+NS_LOG_COMPONENT_DEFINE("ns3.ndn.vsync.scenarios.Hierarchical");
+
+namespace ns3 {
+
+using ndn::vsync::TrafficCounter;
+
+// Generation time and delivery times at the other members of every message.
+std::unordered_map<std::string, std::pair<double, std::vector<double>>>
+    message_delays;
+
+static void MessageEvent(const std::string& msg, bool is_local) {
+  double now = Simulator::Now().GetSeconds();
+  auto& entry = message_delays[msg];
+  if (is_local)
+    entry.first = now;
+  else
+    entry.second.push_back(now);
+}
+
+static ::ndn::vsync::ViewInfo MakeView(const std::vector<std::string>& ids) {
+  std::vector<::ndn::vsync::MemberInfo> mlist;
+  for (const auto& nid : ids) mlist.push_back({::ndn::Name(nid)});
+  return ::ndn::vsync::ViewInfo(mlist);
+}
+
+// Members hang off one access router per subgroup, and the access routers
+// off a core router, so a subgroup is a set of members close to each other.
+// In flat mode all members form one group, as in hub-and-spoke. In
+// hierarchical mode the sync prefix is routed within each subgroup only, and
+// every subgroup has a gateway on the core router that syncs with the other
+// gateways and is joined to its subgroup by a RepresentativeRelay. The
+// relay's transfers are not simulated; they arrive after the delay of the
+// three links from a member to its gateway, and their modeled bytes are
+// added to the traffic totals.
+int main(int argc, char* argv[]) {
+  Config::SetDefault("ns3::DropTailQueue::MaxPackets", StringValue("1000"));
+
+  int N = 200;
+  int SubgroupSize = 20;
+  std::string Mode = "hierarchical";
+  double TotalRunTimeSeconds = 60.0;
+  double DataRate = 0.1;
+  int MaxDataCount = 3;
+  int LinkDelayMS = 10;
+  int RelayWindowMS = 100;
+  double LossRate = 0.0;
+
+  CommandLine cmd;
+  cmd.AddValue("NumOfNodes", "Number of sync nodes in the group", N);
+  cmd.AddValue("SubgroupSize", "Number of members per access router",
+               SubgroupSize);
+  cmd.AddValue("Mode", "flat (one sync group) or hierarchical", Mode);
+  cmd.AddValue("TotalRunTimeSeconds",
+               "Total running time of the simulation in seconds",
+               TotalRunTimeSeconds);
+  cmd.AddValue("DataRate", "Data publishing rate (packets per second)",
+               DataRate);
+  cmd.AddValue("MaxDataCount", "Number of messages each node generates",
+               MaxDataCount);
+  cmd.AddValue("LinkDelayMS", "Delay of every P2P channel in ms",
+               LinkDelayMS);
+  cmd.AddValue("RelayWindowMS",
+               "Messages crossing levels within this window are published "
+               "as one data item",
+               RelayWindowMS);
+  cmd.AddValue("LossRate", "Packet loss rate in the network", LossRate);
+  cmd.Parse(argc, argv);
+
+  if (Mode != "flat" && Mode != "hierarchical") {
+    std::cerr << "Unknown mode: " << Mode << std::endl;
+    return -1;
+  }
+  bool hierarchical = Mode == "hierarchical";
+  SubgroupSize = std::max(SubgroupSize, 1);
+  int S = (N + SubgroupSize - 1) / SubgroupSize;
+
+  // The longest path, member to member across the core, is four links.
+  ::ndn::vsync::SetInterestLifetime(ndn::time::milliseconds(10 * LinkDelayMS),
+                                    ndn::time::milliseconds(10 * LinkDelayMS));
+  ::ndn::vsync::SetHeartbeatInterval(
+      ndn::time::milliseconds(static_cast<int>(1000.0 / DataRate)));
+
+  Config::SetDefault("ns3::PointToPointChannel::Delay",
+                     TimeValue(MilliSeconds(LinkDelayMS)));
+
+  NodeContainer core, routers, members, gateways;
+  core.Create(1);
+  routers.Create(S);
+  members.Create(N);
+  if (hierarchical) gateways.Create(S);
+
+  PointToPointHelper p2p;
+  Ptr<RateErrorModel> rem = CreateObject<RateErrorModel>();
+  rem->SetAttribute("ErrorRate", DoubleValue(LossRate));
+  rem->SetAttribute("ErrorUnit", StringValue("ERROR_UNIT_PACKET"));
+  auto connect = [&](Ptr<Node> a, Ptr<Node> b) {
+    NetDeviceContainer devices = p2p.Install(a, b);
+    devices.Get(0)->SetAttribute("ReceiveErrorModel", PointerValue(rem));
+    devices.Get(1)->SetAttribute("ReceiveErrorModel", PointerValue(rem));
+  };
+  for (int s = 0; s < S; ++s) {
+    connect(core.Get(0), routers.Get(s));
+    if (hierarchical) connect(core.Get(0), gateways.Get(s));
+  }
+  for (int i = 0; i < N; ++i)
+    connect(routers.Get(i / SubgroupSize), members.Get(i));
+
+  ndn::StackHelper ndnHelper;
+  ndnHelper.setCsSize(1000);
+  ndnHelper.InstallAll();
+
+  ndn::StrategyChoiceHelper::InstallAll(::ndn::vsync::kSyncPrefix,
+                                        "/localhost/nfd/strategy/multicast");
+
+  const ::ndn::Name& sync = ::ndn::vsync::kSyncPrefix;
+  std::vector<std::vector<std::string>> subgroups(S);
+  for (int i = 0; i < N; ++i) {
+    std::string nid = "/N" + std::to_string(i + 1);
+    Ptr<Node> router = routers.Get(i / SubgroupSize);
+    subgroups[i / SubgroupSize].push_back(nid);
+    ndn::FibHelper::AddRoute(members.Get(i), "/", router, 1);
+    ndn::FibHelper::AddRoute(members.Get(i), sync, router, 1);
+    ndn::FibHelper::AddRoute(router, nid, members.Get(i), 1);
+    ndn::FibHelper::AddRoute(router, sync, members.Get(i), 1);
+    ndn::FibHelper::AddRoute(core.Get(0), nid, router, 1);
+  }
+  for (int s = 0; s < S; ++s) {
+    ndn::FibHelper::AddRoute(routers.Get(s), "/", core.Get(0), 1);
+    if (!hierarchical) {
+      ndn::FibHelper::AddRoute(routers.Get(s), sync, core.Get(0), 1);
+      ndn::FibHelper::AddRoute(core.Get(0), sync, routers.Get(s), 1);
+      continue;
+    }
+    std::string gid = "/G" + std::to_string(s + 1);
+    ndn::FibHelper::AddRoute(gateways.Get(s), "/", core.Get(0), 1);
+    ndn::FibHelper::AddRoute(gateways.Get(s), sync, core.Get(0), 1);
+    ndn::FibHelper::AddRoute(core.Get(0), gid, gateways.Get(s), 1);
+    ndn::FibHelper::AddRoute(core.Get(0), sync, gateways.Get(s), 1);
+  }
+
+  std::string flat_proto;
+  if (!hierarchical) {
+    std::vector<std::string> all;
+    for (const auto& subgroup : subgroups)
+      all.insert(all.end(), subgroup.begin(), subgroup.end());
+    MakeView(all).Encode(flat_proto);
+  }
+
+  for (int i = 0; i < N; ++i) {
+    std::string nid = "/N" + std::to_string(i + 1);
+    std::string vinfo_proto = flat_proto;
+    if (hierarchical)
+      MakeView(subgroups[i / SubgroupSize]).Encode(vinfo_proto);
+
+    ndn::AppHelper helper("ns3::ndn::vsync::SimpleNodeApp");
+    helper.SetAttribute("NodeID", StringValue(nid));
+    helper.SetAttribute("ViewInfo", StringValue(vinfo_proto));
+    helper.SetAttribute("NodeIndex", UintegerValue(i + 1));
+    helper.SetAttribute("DataRate", DoubleValue(DataRate));
+    helper.SetAttribute("MaxDataCount", UintegerValue(MaxDataCount));
+    helper.SetAttribute("StartTime", TimeValue(Seconds(1.0)));
+    helper.SetAttribute("StopTime", TimeValue(Seconds(TotalRunTimeSeconds)));
+    helper.Install(members.Get(i));
+    members.Get(i)->GetApplication(0)->TraceConnectWithoutContext(
+        "MessageEvent", MakeCallback(&MessageEvent));
+  }
+
+  std::vector<std::unique_ptr<ndn::vsync::RepresentativeRelay>> relays;
+  if (hierarchical) {
+    std::vector<std::string> gids;
+    for (int s = 0; s < S; ++s) gids.push_back("/G" + std::to_string(s + 1));
+    std::string vinfo_proto;
+    MakeView(gids).Encode(vinfo_proto);
+
+    for (int s = 0; s < S; ++s) {
+      ndn::AppHelper helper("ns3::ndn::vsync::SimpleNodeApp");
+      helper.SetAttribute("NodeID", StringValue(gids[s]));
+      helper.SetAttribute("ViewInfo", StringValue(vinfo_proto));
+      helper.SetAttribute("NodeIndex", UintegerValue(N + s + 1));
+      helper.SetAttribute("DataRate", DoubleValue(DataRate));
+      helper.SetAttribute("MaxDataCount", UintegerValue(0));
+      helper.SetAttribute("StartTime", TimeValue(Seconds(1.0)));
+      helper.SetAttribute("StopTime", TimeValue(Seconds(TotalRunTimeSeconds)));
+      helper.Install(gateways.Get(s));
+
+      relays.emplace_back(new ndn::vsync::RepresentativeRelay(
+          DynamicCast<ndn::vsync::SimpleNodeApp>(
+              gateways.Get(s)->GetApplication(0)),
+          MilliSeconds(RelayWindowMS), MilliSeconds(3 * LinkDelayMS), 3));
+      for (int i = s * SubgroupSize; i < std::min(N, (s + 1) * SubgroupSize);
+           ++i)
+        relays.back()->AddMember(DynamicCast<ndn::vsync::SimpleNodeApp>(
+            members.Get(i)->GetApplication(0)));
+    }
+  }
+
+  TrafficCounter::InstallAll();
+
+  std::string file_name = "results/VS-Hierarchical-" + Mode + "N" +
+                          std::to_string(N) + "G" +
+                          std::to_string(SubgroupSize);
+  if (hierarchical && RelayWindowMS != 100)
+    file_name += "W" + std::to_string(RelayWindowMS);
+  if (LossRate > 0.0) file_name += "LR" + std::to_string(LossRate);
+  if (DataRate != 0.1) file_name += "DR" + std::to_string(DataRate);
+  if (RngSeedManager::GetRun() != 1)
+    file_name += "Run" + std::to_string(RngSeedManager::GetRun());
+
+  Simulator::Stop(Seconds(TotalRunTimeSeconds));
+  auto wall_start = std::chrono::steady_clock::now();
+  Simulator::Run();
+  std::chrono::duration<double> wall_time =
+      std::chrono::steady_clock::now() - wall_start;
+  Simulator::Destroy();
+
+  // A message is fully synchronized once every other member has it.
+  std::fstream fs_sync_delay(file_name + "-sync-delay",
+                             std::ios_base::out | std::ios_base::trunc);
+  uint64_t delivered = 0;
+  uint64_t fully_synchronized = 0;
+  double delay_sum = 0.0;
+  double max_delay = 0.0;
+  for (const auto& entry : message_delays) {
+    double gen_time = entry.second.first;
+    const auto& receipts = entry.second.second;
+    for (double t : receipts) delay_sum += t - gen_time;
+    delivered += receipts.size();
+    if (receipts.size() < static_cast<std::size_t>(N - 1)) continue;
+    ++fully_synchronized;
+    double last = *std::max_element(receipts.begin(), receipts.end());
+    fs_sync_delay << gen_time << '\t' << last << std::endl;
+    max_delay = std::max(max_delay, last - gen_time);
+  }
+  fs_sync_delay.close();
+
+  std::cout << "Mode is: " << Mode << std::endl;
+  std::cout << "Number of subgroups is: " << (hierarchical ? S : 1)
+            << std::endl;
+  std::cout << "Total number of messages published is: "
+            << message_delays.size() << std::endl;
+  std::cout << "Total number of messages fully synchronized is: "
+            << fully_synchronized << std::endl;
+  if (!message_delays.empty() && N > 1)
+    std::cout << "Message delivery ratio is: "
+              << static_cast<double>(delivered) /
+                     (message_delays.size() * (N - 1.0))
+              << std::endl;
+  uint64_t up = 0, down = 0, changes = 0, relay_bytes = 0;
+  for (const auto& relay : relays) {
+    up += relay->GetRelayedUp();
+    down += relay->GetRelayedDown();
+    changes += relay->GetRepresentativeChanges();
+    relay_bytes += relay->GetTransferBytes();
+  }
+  uint64_t total_bytes = TrafficCounter::GetTotalBytes() + relay_bytes;
+  if (delivered > 0) {
+    std::cout << "Average message delivery delay is: " << delay_sum / delivered
+              << " seconds." << std::endl;
+    std::cout << "Bytes per delivered message is: "
+              << static_cast<double>(total_bytes) / delivered << std::endl;
+  }
+  std::cout << "Max message sync delay is: " << max_delay << " seconds."
+            << std::endl;
+  std::cout << "Sync interest bytes is: "
+            << TrafficCounter::GetBytes(TrafficCounter::kSyncInterest)
+            << std::endl;
+  std::cout << "Total bytes is: " << total_bytes << std::endl;
+  if (hierarchical) {
+    std::cout << "Relay transfers are modeled, not simulated: "
+              << 3 * LinkDelayMS << " ms and 3 links per transfer, "
+              << "included in the delays and total bytes above."
+              << std::endl;
+    std::cout << "Relay transfer bytes is: " << relay_bytes << std::endl;
+    std::cout << "Messages relayed up is: " << up << std::endl;
+    std::cout << "Messages relayed down is: " << down << std::endl;
+    std::cout << "Representative changes is: " << changes << std::endl;
+  }
+  std::cout << "Simulation wall time is: " << wall_time.count()
+            << " seconds." << std::endl;
+  return 0;
+}
+
+}  // namespace ns3
+
+int main(int argc, char* argv[]) { return ns3::main(argc, argv); }
@@ -15,11 +15,14 @@
 #include "ns3/point-to-point-module.h"
 #include "ns3/random-variable-stream.h"
 
+#include "steady-state.hpp"
+
 NS_LOG_COMPONENT_DEFINE("ns3.ndn.vsync.scenarios.HASCO");
 
 namespace ns3 {
 
 std::unordered_map<std::string, std::pair<double, std::vector<double>>> delays;
+ndn::vsync::SteadyStateDetector steady_state;
 
 static void DataEvent(std::string nid, std::shared_ptr<const ndn::Data> data,
                       bool is_local) {
@@ -30,10 +33,12 @@ static void DataEvent(std::string nid, std::shared_ptr<const ndn::Data> data,
   double now = Simulator::Now().GetSeconds();
 
   auto& entry = delays[name];
-  if (is_local)
+  if (is_local) {
     entry.first = now;
-  else
+  } else {
     entry.second.push_back(now);
+    steady_state.Add(entry.first, now - entry.first);
+  }
 }
 
 static void VectorClockChange(std::string nid, std::size_t idx,
@@ -61,6 +66,9 @@ int main(int argc, char* argv[]) {
   double LossRate = 0.0;
   std::string LinkDelay = "10ms";
   int LeavingNodes = 0;
+  int StartDelayMS = 8000;
+  bool WarmupDetection = false;
+  double CIWidth = 0.0;
 
   CommandLine cmd;
   cmd.AddValue("NumOfNodes", "Number of sync nodes in the group", N);
@@ -76,6 +84,17 @@ int main(int argc, char* argv[]) {
   cmd.AddValue("LeavingNodes",
                "Number of nodes randomly leaving the group after 20s",
                LeavingNodes);
+  cmd.AddValue("StartDelayMS",
+               "Time nodes wait before publishing their first data in ms",
+               StartDelayMS);
+  cmd.AddValue("WarmupDetection",
+               "If set, leave data published during the detected warm-up "
+               "out of the results",
+               WarmupDetection);
+  cmd.AddValue("CIWidth",
+               "If positive, stop once the 95% confidence interval of the "
+               "mean delay is narrower than this fraction of the mean",
+               CIWidth);
   cmd.Parse(argc, argv);
 
   if (TotalRunTimeSeconds < 20.0) return -1;
@@ -103,10 +122,6 @@ int main(int argc, char* argv[]) {
   ndn::StrategyChoiceHelper::InstallAll(::ndn::vsync::kSyncPrefix,
                                         "/localhost/nfd/strategy/multicast");
 
-  Ptr<UniformRandomVariable> seed = CreateObject<UniformRandomVariable>();
-  seed->SetAttribute("Min", DoubleValue(0.0));
-  seed->SetAttribute("Max", DoubleValue(1000.0));
-
   Ptr<UniformRandomVariable> stop_time = CreateObject<UniformRandomVariable>();
   stop_time->SetAttribute("Min", DoubleValue(20.0));
   stop_time->SetAttribute("Max", DoubleValue(TotalRunTimeSeconds));
@@ -116,8 +131,9 @@ int main(int argc, char* argv[]) {
     std::string nid = 'N' + std::to_string(i);
     helper.SetAttribute("NodeID", StringValue(nid));
     if (!Synchronized)
-      helper.SetAttribute("RandomSeed", UintegerValue(seed->GetInteger()));
+      helper.SetAttribute("NodeIndex", UintegerValue(i));
     helper.SetAttribute("StartTime", TimeValue(Seconds(1.0)));
+    helper.SetAttribute("StartDelay", TimeValue(MilliSeconds(StartDelayMS)));
     if (i <= LeavingNodes)
       helper.SetAttribute("StopTime",
                           TimeValue(Seconds(stop_time->GetValue())));
@@ -143,6 +159,10 @@ int main(int argc, char* argv[]) {
   }
 
   Simulator::Stop(Seconds(TotalRunTimeSeconds));
+  if (CIWidth > 0.0) {
+    WarmupDetection = true;
+    steady_state.EnableEarlyStop(CIWidth, Seconds(5.0));
+  }
 
   Simulator::Run();
   Simulator::Destroy();
@@ -153,11 +173,14 @@ int main(int argc, char* argv[]) {
   if (LeavingNodes > 0) file_name += "LN" + std::to_string(LeavingNodes);
   std::fstream fs(file_name, std::ios_base::out | std::ios_base::trunc);
 
+  double warmup_end = WarmupDetection ? steady_state.GetWarmupEnd() : 0.0;
   int count = 0;
   double average_delay = std::accumulate(
       delays.begin(), delays.end(), 0.0,
-      [&count, &fs](double a, const decltype(delays)::value_type& b) {
+      [&count, &fs, warmup_end](double a,
+                                const decltype(delays)::value_type& b) {
         double gen_time = b.second.first;
+        if (gen_time < warmup_end) return a;
         const auto& vec = b.second.second;
         count += vec.size();
         return a + std::accumulate(vec.begin(), vec.end(), 0.0,
@@ -175,6 +198,7 @@ int main(int argc, char* argv[]) {
   std::cout << "Total number of data propagated is: " << count << std::endl;
   std::cout << "Average data propagation delay is: " << average_delay
             << " seconds." << std::endl;
+  if (WarmupDetection) steady_state.Report();
 
   return 0;
 }
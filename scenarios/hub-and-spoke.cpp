@@ -6,6 +6,7 @@
 #include <fstream>
 #include <iostream>
 #include <map>
+#include <stdexcept>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -16,6 +17,16 @@
 #include "ns3/point-to-point-module.h"
 #include "ns3/random-variable-stream.h"
 
+#include "critical-path-tracer.hpp"
+#include "event-log.hpp"
+#include "forwarder-pressure-tracer.hpp"
+#include "queue-monitor.hpp"
+#include "quiescence-monitor.hpp"
+#include "rtt-estimator.hpp"
+#include "sync-aggregation-strategy.hpp"
+#include "traffic-counter.hpp"
+#include "vv-encoding-meter.hpp"
+
 NS_LOG_COMPONENT_DEFINE("ns3.ndn.vsync.scenarios.HubAndSpoke");
 
 namespace ns3 {
@@ -25,6 +36,7 @@ std::unordered_map<std::string, std::pair<double, std::vector<double>>> delays;
 static void DataEvent(std::string nid, std::shared_ptr<const ndn::Data> data,
                       bool is_local) {
   auto name = data->getName().toUri();
+  ndn::vsync::EventLog::DataEvent(nid, name, is_local);
   /*
   NS_LOG_INFO("new_data_name=" << name << ", node_id=" << nid << ", is_local="
                                << (is_local ? "true" : "false"));
@@ -37,13 +49,65 @@ static void DataEvent(std::string nid, std::shared_ptr<const ndn::Data> data,
   else
     entry.second.push_back(now);
 }
-/*
+// Generation time and receive times of every application message.
+std::unordered_map<std::string, std::pair<double, std::vector<double>>>
+    message_delays;
+
+static void MessageEvent(const std::string& msg, bool is_local) {
+  double now = Simulator::Now().GetSeconds();
+  auto& entry = message_delays[msg];
+  if (is_local)
+    entry.first = now;
+  else
+    entry.second.push_back(now);
+}
+
+// Publish time and completion times of every object, with its size.
+std::unordered_map<std::string, std::pair<double, std::vector<double>>>
+    object_delays;
+uint64_t object_bytes_received = 0;
+
+static void ObjectEvent(const std::string& id, std::size_t bytes,
+                        bool is_local) {
+  double now = Simulator::Now().GetSeconds();
+  auto& entry = object_delays[id];
+  if (is_local) {
+    entry.first = now;
+  } else {
+    entry.second.push_back(now);
+    object_bytes_received += bytes;
+  }
+}
+
+// Depth and recovery time in seconds of every completed catch-up.
+std::vector<std::pair<uint64_t, double>> catch_ups;
+
+static void CatchUpEvent(const std::string& member, uint64_t depth,
+                         Time recovery) {
+  catch_ups.emplace_back(depth, recovery.GetSeconds());
+}
+
+// Peak item count and bytes of every node's accounted data store.
+std::map<std::string, std::pair<std::size_t, std::size_t>> data_store_peaks;
+uint64_t fetch_hits = 0;
+uint64_t fetch_misses = 0;
+
+static void DataStore(std::string nid, std::size_t items, std::size_t bytes) {
+  auto& peak = data_store_peaks[nid];
+  peak.first = std::max(peak.first, items);
+  peak.second = std::max(peak.second, bytes);
+}
+
+static void Fetch(bool retained) { ++(retained ? fetch_hits : fetch_misses); }
+
 static void VectorChange(std::string nid, std::size_t idx,
                          const ::ndn::vsync::VersionVector& vc) {
+  ndn::vsync::EventLog::VectorChange(nid, idx, vc);
+  /*
   NS_LOG_INFO("node_id=\"" << nid << "\", node_index=" << idx
                            << ", vector_clock=" << vc);
+  */
 }
-*/
 
 std::map<::ndn::vsync::ViewID, std::pair<double, std::vector<double>>,
          ::ndn::vsync::VIDCompare>
@@ -51,6 +115,7 @@ std::map<::ndn::vsync::ViewID, std::pair<double, std::vector<double>>,
 
 static void ViewChange(std::string nid, const ::ndn::vsync::ViewID& vid,
                        const ::ndn::vsync::ViewInfo& vinfo, bool is_leader) {
+  ndn::vsync::EventLog::ViewChange(nid, vid, vinfo, is_leader);
   NS_LOG_INFO("node_id=\"" << nid << "\", is_leader=" << (is_leader ? 'Y' : 'N')
                            << ", view_id=" << vid << ", view_info=" << vinfo);
 
@@ -63,7 +128,12 @@ static void ViewChange(std::string nid, const ::ndn::vsync::ViewID& vid,
     entry.second.push_back(now);
 }
 
+int heartbeat_periods = 0;
+
+static void Heartbeat(Time interval) { ++heartbeat_periods; }
+
 static void NodeStop(std::string nid) {
+  ndn::vsync::EventLog::NodeStop(nid);
   NS_LOG_INFO("node " << nid << " stops");
 }
 
@@ -82,6 +152,33 @@ int main(int argc, char* argv[]) {
   int LeavingNodes = 0;
   double DataRate = 1.0;
   int HBMultiple = 1;
+  std::string HeartbeatMode = "fixed";
+  int HBMaxMultiple = 8;
+  double CsPitSamplePeriod = 0.0;
+  int CoalesceWindowMS = 0;
+  int MaxBatchSize = 16;
+  bool AdaptiveLifetime = false;
+  int MinLifetimeMS = 10;
+  std::string SyncStrategy = "multicast";
+  int AggregationWindowMS = 5;
+  double CriticalPathSampleRate = 0.0;
+  int CriticalPathThresholdMS = 500;
+  int MaxDataCount = 100;
+  bool StopWhenQuiescent = false;
+  double QuiescenceGraceSeconds = 1.0;
+  bool BinaryEventLog = false;
+  double QueueSamplePeriod = 0.0;
+  bool MeasureVVEncoding = false;
+  int ObjectSize = 0;
+  int SegmentSize = 1024;
+  int PipelineWindow = 8;
+  std::string ObjectMode = "manifest";
+  bool CatchUp = false;
+  int CatchUpThreshold = 4;
+  int CatchUpMaxWindow = 32;
+  std::string RetentionLimit = "none";
+  uint64_t RetentionMax = 0;
+  std::string RetentionEviction = "lru";
 
   CommandLine cmd;
   cmd.AddValue("NumOfNodes", "Number of sync nodes in the group", N);
@@ -102,14 +199,122 @@ int main(int argc, char* argv[]) {
   cmd.AddValue("HBMultiple",
                "Heartbeat interval as a multiple of the data interval",
                HBMultiple);
+  cmd.AddValue("HeartbeatMode",
+               "fixed, or adaptive between HBMultiple and HBMaxMultiple",
+               HeartbeatMode);
+  cmd.AddValue("HBMaxMultiple",
+               "Longest adaptive heartbeat as a multiple of the data interval",
+               HBMaxMultiple);
+  cmd.AddValue("CsPitSamplePeriod",
+               "CS and PIT sampling period in seconds (default 0, disabled)",
+               CsPitSamplePeriod);
+  cmd.AddValue("CoalesceWindowMS",
+               "Window in ms for batching messages into one data item (0 to "
+               "publish each message on its own)",
+               CoalesceWindowMS);
+  cmd.AddValue("MaxBatchSize", "Maximum number of messages in one data item",
+               MaxBatchSize);
+  cmd.AddValue("AdaptiveLifetime",
+               "If set, interest lifetimes follow measured RTTs, bounded by "
+               "the static lifetimes",
+               AdaptiveLifetime);
+  cmd.AddValue("MinLifetimeMS", "Shortest adaptive interest lifetime in ms",
+               MinLifetimeMS);
+  cmd.AddValue("SyncStrategy",
+               "Hub strategy for sync interests: multicast or aggregation",
+               SyncStrategy);
+  cmd.AddValue("AggregationWindowMS",
+               "Window in ms for merging dominated sync interests at the hub",
+               AggregationWindowMS);
+  cmd.AddValue("CriticalPathSampleRate",
+               "Fraction of data items traced end to end (default 0, disabled)",
+               CriticalPathSampleRate);
+  cmd.AddValue("CriticalPathThresholdMS",
+               "Sync delay in ms above which a traced item is broken down",
+               CriticalPathThresholdMS);
+  cmd.AddValue("MaxDataCount", "Number of messages each node generates",
+               MaxDataCount);
+  cmd.AddValue("StopWhenQuiescent",
+               "If set, stop once all messages are generated and delivered "
+               "instead of at TotalRunTimeSeconds",
+               StopWhenQuiescent);
+  cmd.AddValue("QuiescenceGraceSeconds",
+               "Simulated time to keep running after the group is quiescent",
+               QuiescenceGraceSeconds);
+  cmd.AddValue("BinaryEventLog",
+               "If set, log sync events to <result file>-events.bin",
+               BinaryEventLog);
+  cmd.AddValue("QueueSamplePeriod",
+               "Link queue sampling period in seconds (0 to disable the "
+               "queue monitor)",
+               QueueSamplePeriod);
+  cmd.AddValue("MeasureVVEncoding",
+               "If set, report sync interest bytes with compact version "
+               "vector encodings",
+               MeasureVVEncoding);
+  cmd.AddValue("ObjectSize",
+               "Size in bytes of the object each message stands for (0 for "
+               "plain messages)",
+               ObjectSize);
+  cmd.AddValue("SegmentSize", "Size in bytes of an object segment",
+               SegmentSize);
+  cmd.AddValue("PipelineWindow",
+               "Segment interests in flight per object at a receiver",
+               PipelineWindow);
+  cmd.AddValue("ObjectMode",
+               "manifest (one sync update per object, segments fetched) or "
+               "versions (one sync update per segment)",
+               ObjectMode);
+  cmd.AddValue("CatchUp",
+               "If set, nodes far behind a member prefetch the missing range "
+               "with an AIMD interest window",
+               CatchUp);
+  cmd.AddValue("CatchUpThreshold",
+               "Number of items behind a member that starts a catch-up",
+               CatchUpThreshold);
+  cmd.AddValue("CatchUpMaxWindow",
+               "Maximum catch-up interests in flight per member",
+               CatchUpMaxWindow);
+  cmd.AddValue("RetentionLimit",
+               "What bounds each node's accounted data store: none, count, "
+               "bytes or age",
+               RetentionLimit);
+  cmd.AddValue("RetentionMax",
+               "Items, bytes or milliseconds a data store may hold (above 0 "
+               "unless RetentionLimit is none)",
+               RetentionMax);
+  cmd.AddValue("RetentionEviction",
+               "lru, or window (drop the oldest item of the largest "
+               "publisher)",
+               RetentionEviction);
   cmd.Parse(argc, argv);
 
+  try {
+    ::ndn::vsync::app::RetentionPolicy::Parse(RetentionLimit, RetentionMax,
+                                              RetentionEviction);
+  } catch (const std::invalid_argument& e) {
+    std::cerr << e.what() << std::endl;
+    return -1;
+  }
+
   ::ndn::vsync::SetInterestLifetime(ndn::time::milliseconds(5 * LinkDelayMS),
                                     ndn::time::milliseconds(5 * LinkDelayMS));
 
   ::ndn::vsync::SetHeartbeatInterval(ndn::time::milliseconds(
       HBMultiple * static_cast<int>(1000.0 / DataRate)));
 
+  if (HeartbeatMode != "fixed" && HeartbeatMode != "adaptive") {
+    std::cerr << "Unknown heartbeat mode: " << HeartbeatMode << std::endl;
+    return -1;
+  }
+  bool adaptive_heartbeat = HeartbeatMode == "adaptive";
+  if (ObjectMode != "manifest" && ObjectMode != "versions") {
+    std::cerr << "Unknown object mode: " << ObjectMode << std::endl;
+    return -1;
+  }
+  int data_interval_ms = static_cast<int>(1000.0 / DataRate);
+  Time heartbeat = MilliSeconds(HBMultiple * data_interval_ms);
+
   NodeContainer nodes;
   nodes.Create(N + 1);
 
@@ -133,10 +338,15 @@ int main(int argc, char* argv[]) {
 
   ndn::StrategyChoiceHelper::InstallAll(::ndn::vsync::kSyncPrefix,
                                         "/localhost/nfd/strategy/multicast");
-
-  Ptr<UniformRandomVariable> seed = CreateObject<UniformRandomVariable>();
-  seed->SetAttribute("Min", DoubleValue(0.0));
-  seed->SetAttribute("Max", DoubleValue(1000.0));
+  if (SyncStrategy == "aggregation") {
+    nfd::fw::SyncAggregationStrategy::SetAggregationWindow(
+        ndn::time::milliseconds(AggregationWindowMS));
+    ndn::StrategyChoiceHelper::Install<nfd::fw::SyncAggregationStrategy>(
+        nodes.Get(0), ::ndn::vsync::kSyncPrefix);
+  } else if (SyncStrategy != "multicast") {
+    std::cerr << "Unknown sync strategy: " << SyncStrategy << std::endl;
+    return -1;
+  }
 
   Ptr<UniformRandomVariable> stop_time = CreateObject<UniformRandomVariable>();
   stop_time->SetAttribute("Min", DoubleValue(10.0));
@@ -153,25 +363,68 @@ int main(int argc, char* argv[]) {
 
   std::map<double, int> group_size;
 
+  ndn::vsync::RttEstimator rtt_estimator(
+      ndn::time::milliseconds(5 * LinkDelayMS),
+      ndn::time::milliseconds(5 * LinkDelayMS),
+      ndn::time::milliseconds(MinLifetimeMS));
+  if (AdaptiveLifetime) rtt_estimator.EnableAdaptiveLifetimes();
+  ndn::vsync::CriticalPathTracer critical_path(
+      CriticalPathSampleRate, CriticalPathThresholdMS / 1000.0);
+  critical_path.SetViewInfo(vinfo);
+
+  ndn::vsync::QuiescenceMonitor quiescence(Seconds(QuiescenceGraceSeconds));
+
   for (int i = 1; i <= N; ++i) {
     ndn::AppHelper helper("ns3::ndn::vsync::SimpleNodeApp");
     std::string nid = "/N" + std::to_string(i);
     helper.SetAttribute("NodeID", StringValue(nid));
     helper.SetAttribute("ViewInfo", StringValue(vinfo_proto));
     if (!Synchronized)
-      helper.SetAttribute("RandomSeed", UintegerValue(seed->GetInteger()));
+      helper.SetAttribute("NodeIndex", UintegerValue(i));
     helper.SetAttribute("DataRate", DoubleValue(DataRate));
+    helper.SetAttribute("MaxDataCount", UintegerValue(MaxDataCount));
     helper.SetAttribute("StartTime", TimeValue(Seconds(1.0)));
+    if (adaptive_heartbeat) {
+      helper.SetAttribute("AdaptiveHeartbeat", BooleanValue(true));
+      helper.SetAttribute("HeartbeatMin", TimeValue(heartbeat));
+      helper.SetAttribute("HeartbeatMax",
+                          TimeValue(MilliSeconds(HBMaxMultiple *
+                                                 data_interval_ms)));
+    }
+    if (CoalesceWindowMS > 0) {
+      helper.SetAttribute("CoalesceWindow",
+                          TimeValue(MilliSeconds(CoalesceWindowMS)));
+      helper.SetAttribute("MaxBatchSize", UintegerValue(MaxBatchSize));
+    }
+    if (ObjectSize > 0) {
+      helper.SetAttribute("ObjectSize", UintegerValue(ObjectSize));
+      helper.SetAttribute("SegmentSize", UintegerValue(SegmentSize));
+      helper.SetAttribute("PipelineWindow", UintegerValue(PipelineWindow));
+      helper.SetAttribute("SegmentsAsVersions",
+                          BooleanValue(ObjectMode == "versions"));
+    }
+    if (CatchUp) {
+      helper.SetAttribute("CatchUpEnabled", BooleanValue(true));
+      helper.SetAttribute("CatchUpThreshold", UintegerValue(CatchUpThreshold));
+      helper.SetAttribute("CatchUpMaxWindow", UintegerValue(CatchUpMaxWindow));
+    }
+    if (RetentionLimit != "none") {
+      helper.SetAttribute("RetentionLimit", StringValue(RetentionLimit));
+      helper.SetAttribute("RetentionMax", UintegerValue(RetentionMax));
+      helper.SetAttribute("RetentionEviction", StringValue(RetentionEviction));
+    }
     if (i <= LeavingNodes) {
       double st = stop_time->GetValue();
       group_size[st] = 0;
       std::cout << "node " << nid << " leaves at " << st << std::endl;
       Simulator::Schedule(Seconds(st), NodeStop, nid);
+      quiescence.AddDeparture(nid, Seconds(st));
       helper.SetAttribute("StopTime", TimeValue(Seconds(st)));
     } else {
       helper.SetAttribute("StopTime", TimeValue(Seconds(TotalRunTimeSeconds)));
     }
     helper.Install(nodes.Get(i));
+    if (AdaptiveLifetime || LossRate > 0.0) rtt_estimator.Install(nodes.Get(i));
 
     ndn::FibHelper::AddRoute(nodes.Get(0), ::ndn::vsync::kSyncPrefix,
                              nodes.Get(i), 1);
@@ -181,12 +434,29 @@ int main(int argc, char* argv[]) {
     ndn::FibHelper::AddRoute(nodes.Get(i), ::ndn::vsync::kSyncPrefix,
                              nodes.Get(0), 1);
 
-    // nodes.Get(i)->GetApplication(0)->TraceConnect("VectorChange", nid,
-    //                                               MakeCallback(&VectorChange));
+    if (BinaryEventLog)
+      nodes.Get(i)->GetApplication(0)->TraceConnect(
+          "VectorChange", nid, MakeCallback(&VectorChange));
     nodes.Get(i)->GetApplication(0)->TraceConnect("ViewChange", nid,
                                                   MakeCallback(&ViewChange));
     nodes.Get(i)->GetApplication(0)->TraceConnect("DataEvent", nid,
                                                   MakeCallback(&DataEvent));
+    nodes.Get(i)->GetApplication(0)->TraceConnectWithoutContext(
+        "Heartbeat", MakeCallback(&Heartbeat));
+    nodes.Get(i)->GetApplication(0)->TraceConnectWithoutContext(
+        "MessageEvent", MakeCallback(&MessageEvent));
+    nodes.Get(i)->GetApplication(0)->TraceConnectWithoutContext(
+        "ObjectEvent", MakeCallback(&ObjectEvent));
+    nodes.Get(i)->GetApplication(0)->TraceConnectWithoutContext(
+        "CatchUp", MakeCallback(&CatchUpEvent));
+    nodes.Get(i)->GetApplication(0)->TraceConnect("DataStore", nid,
+                                                  MakeCallback(&DataStore));
+    nodes.Get(i)->GetApplication(0)->TraceConnectWithoutContext(
+        "Fetch", MakeCallback(&Fetch));
+    if (CriticalPathSampleRate > 0.0)
+      critical_path.Connect(nodes.Get(i)->GetApplication(0), nid);
+    if (StopWhenQuiescent)
+      quiescence.Connect(nodes.Get(i)->GetApplication(0), nid);
   }
 
   Simulator::Stop(Seconds(TotalRunTimeSeconds));
@@ -203,12 +473,55 @@ int main(int argc, char* argv[]) {
   if (LossRate > 0.0) file_name += "LR" + std::to_string(LossRate);
   if (DataRate != 1.0) file_name += "DR" + std::to_string(DataRate);
   if (LeavingNodes > 0) file_name += "LN" + std::to_string(LeavingNodes);
+  if (AdaptiveLifetime) file_name += "RTT";
+  if (CoalesceWindowMS > 0)
+    file_name += "CW" + std::to_string(CoalesceWindowMS) + "B" +
+                 std::to_string(MaxBatchSize);
+  if (RngSeedManager::GetRun() != 1)
+    file_name += "Run" + std::to_string(RngSeedManager::GetRun());
   if (HBMultiple != 1) file_name += "HB" + std::to_string(HBMultiple);
-
-  ndn::L3RateTracer::InstallAll(file_name + "-rate-trace.txt",
-                                Seconds(TotalRunTimeSeconds - 0.1));
+  if (adaptive_heartbeat) file_name += "AHB" + std::to_string(HBMaxMultiple);
+  if (SyncStrategy == "aggregation")
+    file_name += "AGG" + std::to_string(AggregationWindowMS);
+  if (MaxDataCount != 100) file_name += "MD" + std::to_string(MaxDataCount);
+  if (ObjectSize > 0)
+    file_name += "OS" + std::to_string(ObjectSize) + "S" +
+                 std::to_string(SegmentSize) +
+                 (ObjectMode == "versions"
+                      ? std::string("V")
+                      : "W" + std::to_string(PipelineWindow));
+  if (CatchUp)
+    file_name += "CU" + std::to_string(CatchUpThreshold) + "W" +
+                 std::to_string(CatchUpMaxWindow);
+  if (RetentionLimit != "none")
+    file_name += "RL" + RetentionLimit + std::to_string(RetentionMax) +
+                 (RetentionEviction == "window" ? "W" : "");
+
+  // The rate trace is one averaging period over the whole run, unless the
+  // run may end early.
+  ndn::L3RateTracer::InstallAll(
+      file_name + "-rate-trace.txt",
+      StopWhenQuiescent ? Seconds(1.0) : Seconds(TotalRunTimeSeconds - 0.1));
+
+  if (CsPitSamplePeriod > 0.0)
+    ndn::vsync::ForwarderPressureTracer::InstallAll(
+        file_name + "-cs-pit-trace.txt", Seconds(CsPitSamplePeriod));
+
+  ndn::vsync::TrafficCounter::InstallAll();
+
+  if (BinaryEventLog)
+    ndn::vsync::EventLog::Open(file_name + "-events.bin");
+
+  ndn::vsync::QueueMonitor queue_monitor(Seconds(QueueSamplePeriod));
+  if (QueueSamplePeriod > 0.0) queue_monitor.InstallAll();
+  ndn::vsync::VVEncodingMeter vv_encoding_meter;
+  if (MeasureVVEncoding) vv_encoding_meter.InstallAll();
 
   Simulator::Run();
+  ndn::vsync::EventLog::Close();
+  if (QueueSamplePeriod > 0.0) queue_monitor.Report(file_name + "-queue.txt");
+  if (MeasureVVEncoding) vv_encoding_meter.Report();
+  double run_time = Simulator::Now().GetSeconds();
   Simulator::Destroy();
 
   std::fstream fs_sync_delay(file_name + "-sync-delay",
@@ -217,12 +530,14 @@ int main(int argc, char* argv[]) {
                              std::ios_base::out | std::ios_base::trunc);
 
   int fully_synchronized_data = 0;
+  uint64_t delivered_data = 0;
   double average_delay = 0.0;
   double max_delay = 0.0;
   for (auto iter = delays.begin(); iter != delays.end(); ++iter) {
     const auto& s = iter->first;
     double gen_time = iter->second.first;
     const auto& vec = iter->second.second;
+    delivered_data += vec.size();
     int gs = group_size.upper_bound(gen_time)->second;
     if (vec.size() != gs - 1 || vec.size() == 0) {
       std::cout << "name: " << s << ", gen_time: " << gen_time
@@ -257,6 +572,133 @@ int main(int argc, char* argv[]) {
   std::cout << "Average data propagation delay is: " << average_delay
             << " seconds." << std::endl;
 
+  using ndn::vsync::TrafficCounter;
+  std::cout << "Sync interest bytes is: "
+            << TrafficCounter::GetBytes(TrafficCounter::kSyncInterest)
+            << std::endl;
+  if (delivered_data > 0) {
+    std::cout << "Sync interest bytes per delivered data is: "
+              << static_cast<double>(
+                     TrafficCounter::GetBytes(TrafficCounter::kSyncInterest)) /
+                     delivered_data
+              << std::endl;
+    std::cout << "Total bytes per delivered data is: "
+              << static_cast<double>(TrafficCounter::GetTotalBytes()) /
+                     delivered_data
+              << std::endl;
+  }
+
+  uint64_t delivered_messages = 0;
+  double message_delay = 0.0;
+  for (const auto& entry : message_delays) {
+    for (double t : entry.second.second) {
+      message_delay += t - entry.second.first;
+      ++delivered_messages;
+    }
+  }
+  std::cout << "Total number of messages published is: "
+            << message_delays.size() << std::endl;
+  std::cout << "Messages delivered per second is: "
+            << delivered_messages / (run_time - 1.0) << std::endl;
+  if (delivered_messages > 0) {
+    std::cout << "Bytes per delivered message is: "
+              << static_cast<double>(TrafficCounter::GetTotalBytes()) /
+                     delivered_messages
+              << std::endl;
+    std::cout << "Average message delivery delay is: "
+              << message_delay / delivered_messages << " seconds."
+              << std::endl;
+  }
+
+  // Memory per member that a store bounded by the retention policy would
+  // take. This is accounted, not held: the sync node still keeps every item.
+  // Fetches for items a node no longer accounts for are deliveries the
+  // policy would have cost; check them against the delivery completion
+  // above when sizing memory.
+  if (RetentionLimit != "none") {
+    std::size_t peak_bytes = 0;
+    std::size_t peak_items = 0;
+    double average_peak_bytes = 0.0;
+    for (const auto& entry : data_store_peaks) {
+      peak_items = std::max(peak_items, entry.second.first);
+      peak_bytes = std::max(peak_bytes, entry.second.second);
+      average_peak_bytes += entry.second.second;
+    }
+    if (!data_store_peaks.empty())
+      average_peak_bytes /= data_store_peaks.size();
+    std::cout << "Peak accounted store bytes per node is: " << peak_bytes
+              << std::endl;
+    std::cout << "Average peak accounted store bytes per node is: "
+              << average_peak_bytes << std::endl;
+    std::cout << "Peak accounted store items per node is: " << peak_items
+              << std::endl;
+    std::cout << "Fetches for evicted items is: " << fetch_misses
+              << std::endl;
+    if (fetch_hits + fetch_misses > 0)
+      std::cout << "Fetch hit ratio is: "
+                << static_cast<double>(fetch_hits) /
+                       (fetch_hits + fetch_misses)
+                << std::endl;
+  }
+
+  // Compare with a run without --CatchUp for the change in max delay.
+  if (CatchUp) {
+    double depth = 0.0;
+    double recovery = 0.0;
+    double max_recovery = 0.0;
+    for (const auto& c : catch_ups) {
+      depth += c.first;
+      recovery += c.second;
+      max_recovery = std::max(max_recovery, c.second);
+    }
+    std::cout << "Total number of catch-ups is: " << catch_ups.size()
+              << std::endl;
+    if (!catch_ups.empty()) {
+      std::cout << "Average catch-up depth is: " << depth / catch_ups.size()
+                << " items." << std::endl;
+      std::cout << "Average catch-up recovery time is: "
+                << recovery / catch_ups.size() << " seconds." << std::endl;
+      std::cout << "Max catch-up recovery time is: " << max_recovery
+                << " seconds." << std::endl;
+    }
+  }
+
+  // Compare runs with --ObjectMode=manifest and --ObjectMode=versions for the
+  // cost of announcing every segment through sync.
+  if (ObjectSize > 0) {
+    uint64_t completed_objects = 0;
+    double object_delay = 0.0;
+    double max_object_delay = 0.0;
+    for (const auto& entry : object_delays) {
+      for (double t : entry.second.second) {
+        double d = t - entry.second.first;
+        object_delay += d;
+        max_object_delay = std::max(max_object_delay, d);
+        ++completed_objects;
+      }
+    }
+    std::cout << "Total number of objects published is: "
+              << object_delays.size() << std::endl;
+    std::cout << "Total number of objects received is: " << completed_objects
+              << std::endl;
+    if (completed_objects > 0) {
+      std::cout << "Average object completion latency is: "
+                << object_delay / completed_objects << " seconds."
+                << std::endl;
+      std::cout << "Max object completion latency is: " << max_object_delay
+                << " seconds." << std::endl;
+    }
+    std::cout << "Object goodput is: "
+              << object_bytes_received / (run_time - 1.0)
+              << " bytes per second." << std::endl;
+  }
+
+  // The bytes saved are measured against a run with the same seed and
+  // --HeartbeatMode=fixed (see HeartbeatSweep in run.py).
+  if (adaptive_heartbeat)
+    std::cout << "Adaptive heartbeat periods is: " << heartbeat_periods
+              << std::endl;
+
   double max_view_change_delay = 0.0;
   for (auto iter = view_change_delays.begin(); iter != view_change_delays.end();
        ++iter) {
@@ -275,6 +717,13 @@ int main(int argc, char* argv[]) {
   std::cout << "Max view change delay is: " << max_view_change_delay
             << " seconds." << std::endl;
 
+  if (CriticalPathSampleRate > 0.0)
+    critical_path.Report(file_name + "-critical-path.txt");
+
+  if (AdaptiveLifetime || LossRate > 0.0) rtt_estimator.Report();
+
+  if (StopWhenQuiescent) quiescence.Report(Seconds(TotalRunTimeSeconds));
+
   return 0;
 }
 
@@ -16,6 +16,12 @@
 #include "ns3/point-to-point-module.h"
 #include "ns3/random-variable-stream.h"
 
+#include "event-log.hpp"
+#include "forwarder-pressure-tracer.hpp"
+#include "queue-monitor.hpp"
+#include "rtt-estimator.hpp"
+#include "vv-encoding-meter.hpp"
+
 NS_LOG_COMPONENT_DEFINE("ns3.ndn.vsync.scenarios.Large");
 
 namespace ns3 {
@@ -25,6 +31,7 @@ std::unordered_map<std::string, std::pair<double, std::vector<double>>> delays;
 static void DataEvent(std::string nid, std::shared_ptr<const ndn::Data> data,
                       bool is_local) {
   auto name = data->getName().toUri();
+  ndn::vsync::EventLog::DataEvent(nid, name, is_local);
   /*
   NS_LOG_INFO("new_data_name=" << name << ", node_id=" << nid << ", is_local="
                                << (is_local ? "true" : "false"));
@@ -44,6 +51,7 @@ std::map<::ndn::vsync::ViewID, std::pair<double, std::vector<double>>,
 
 static void ViewChange(std::string nid, const ::ndn::vsync::ViewID& vid,
                        const ::ndn::vsync::ViewInfo& vinfo, bool is_leader) {
+  ndn::vsync::EventLog::ViewChange(nid, vid, vinfo, is_leader);
   NS_LOG_INFO("node_id=\"" << nid << "\", is_leader=" << (is_leader ? 'Y' : 'N')
                            << ", view_id=" << vid << ", view_info=" << vinfo);
 
@@ -56,7 +64,13 @@ static void ViewChange(std::string nid, const ::ndn::vsync::ViewID& vid,
     entry.second.push_back(now);
 }
 
+static void VectorChange(std::string nid, std::size_t idx,
+                         const ::ndn::vsync::VersionVector& vv) {
+  ndn::vsync::EventLog::VectorChange(nid, idx, vv);
+}
+
 static void NodeStop(std::string nid) {
+  ndn::vsync::EventLog::NodeStop(nid);
   NS_LOG_INFO("node /" << nid << " stops");
 }
 
@@ -68,6 +82,12 @@ int main(int argc, char* argv[]) {
   bool Synchronized = false;
   double DataRate = 1.0;
   int LeavingNodes = 0;
+  double CsPitSamplePeriod = 0.0;
+  bool AdaptiveLifetime = false;
+  int MinLifetimeMS = 10;
+  bool BinaryEventLog = false;
+  double QueueSamplePeriod = 0.0;
+  bool MeasureVVEncoding = false;
 
   ::ndn::vsync::SetInterestLifetime(ndn::time::milliseconds(500),
                                     ndn::time::milliseconds(500));
@@ -86,6 +106,26 @@ int main(int argc, char* argv[]) {
                LeavingNodes);
   cmd.AddValue("DataRate", "Data publishing rate (packets per second)",
                DataRate);
+  cmd.AddValue("CsPitSamplePeriod",
+               "CS and PIT sampling period in seconds (default 0, disabled)",
+               CsPitSamplePeriod);
+  cmd.AddValue("AdaptiveLifetime",
+               "If set, interest lifetimes follow measured RTTs, bounded by "
+               "the static lifetimes",
+               AdaptiveLifetime);
+  cmd.AddValue("MinLifetimeMS", "Shortest adaptive interest lifetime in ms",
+               MinLifetimeMS);
+  cmd.AddValue("BinaryEventLog",
+               "If set, log sync events to <result file>-events.bin",
+               BinaryEventLog);
+  cmd.AddValue("QueueSamplePeriod",
+               "Link queue sampling period in seconds (0 to disable the "
+               "queue monitor)",
+               QueueSamplePeriod);
+  cmd.AddValue("MeasureVVEncoding",
+               "If set, report sync interest bytes with compact version "
+               "vector encodings",
+               MeasureVVEncoding);
   cmd.Parse(argc, argv);
 
   ::ndn::vsync::SetHeartbeatInterval(
@@ -107,10 +147,6 @@ int main(int argc, char* argv[]) {
   ndn::StrategyChoiceHelper::InstallAll(::ndn::vsync::kSyncPrefix,
                                         "/localhost/nfd/strategy/multicast");
 
-  Ptr<UniformRandomVariable> seed = CreateObject<UniformRandomVariable>();
-  seed->SetAttribute("Min", DoubleValue(0.0));
-  seed->SetAttribute("Max", DoubleValue(1000.0));
-
   Ptr<UniformRandomVariable> stop_time = CreateObject<UniformRandomVariable>();
   stop_time->SetAttribute("Min", DoubleValue(10.0));
   stop_time->SetAttribute("Max", DoubleValue(TotalRunTimeSeconds));
@@ -137,6 +173,11 @@ int main(int argc, char* argv[]) {
 
   std::map<double, int> group_size;
 
+  ndn::vsync::RttEstimator rtt_estimator(
+      ndn::time::milliseconds(500), ndn::time::milliseconds(500),
+      ndn::time::milliseconds(MinLifetimeMS));
+  if (AdaptiveLifetime) rtt_estimator.EnableAdaptiveLifetimes();
+
   for (size_t i = 0; i < nodes.size(); ++i) {
     const std::string& nid = nodes[i];
     Ptr<Node> node = Names::Find<Node>(nid);
@@ -156,8 +197,9 @@ int main(int argc, char* argv[]) {
     }
     helper.SetAttribute("DataRate", DoubleValue(DataRate));
     if (!Synchronized)
-      helper.SetAttribute("RandomSeed", UintegerValue(seed->GetInteger()));
+      helper.SetAttribute("NodeIndex", UintegerValue(i));
     helper.Install(node);
+    if (AdaptiveLifetime || LossRate > 0.0) rtt_estimator.Install(node);
 
     ndnGlobalRoutingHelper.AddOrigins('/' + nid, node);
     ndnGlobalRoutingHelper.AddOrigins(::ndn::vsync::kSyncPrefix.toUri(), node);
@@ -167,6 +209,9 @@ int main(int argc, char* argv[]) {
 
     node->GetApplication(0)->TraceConnect("ViewChange", nid,
                                           MakeCallback(&ViewChange));
+    if (BinaryEventLog)
+      node->GetApplication(0)->TraceConnect("VectorChange", nid,
+                                            MakeCallback(&VectorChange));
   }
 
   ndn::GlobalRoutingHelper::CalculateRoutes();
@@ -185,11 +230,29 @@ int main(int argc, char* argv[]) {
   if (LossRate > 0.0) file_name += "LR" + std::to_string(LossRate);
   if (DataRate != 1.0) file_name += "DR" + std::to_string(DataRate);
   if (LeavingNodes > 0) file_name += "LN" + std::to_string(LeavingNodes);
+  if (AdaptiveLifetime) file_name += "RTT";
+  if (RngSeedManager::GetRun() != 1)
+    file_name += "Run" + std::to_string(RngSeedManager::GetRun());
 
   ndn::L3RateTracer::InstallAll(file_name + "-rate-trace.txt",
                                 Seconds(TotalRunTimeSeconds - 0.1));
 
+  if (CsPitSamplePeriod > 0.0)
+    ndn::vsync::ForwarderPressureTracer::InstallAll(
+        file_name + "-cs-pit-trace.txt", Seconds(CsPitSamplePeriod));
+
+  if (BinaryEventLog)
+    ndn::vsync::EventLog::Open(file_name + "-events.bin");
+
+  ndn::vsync::QueueMonitor queue_monitor(Seconds(QueueSamplePeriod));
+  if (QueueSamplePeriod > 0.0) queue_monitor.InstallAll();
+  ndn::vsync::VVEncodingMeter vv_encoding_meter;
+  if (MeasureVVEncoding) vv_encoding_meter.InstallAll();
+
   Simulator::Run();
+  ndn::vsync::EventLog::Close();
+  if (QueueSamplePeriod > 0.0) queue_monitor.Report(file_name + "-queue.txt");
+  if (MeasureVVEncoding) vv_encoding_meter.Report();
   Simulator::Destroy();
 
   std::fstream fs(file_name, std::ios_base::out | std::ios_base::trunc);
@@ -258,6 +321,8 @@ int main(int argc, char* argv[]) {
   std::cout << "Max view change delay is: " << max_view_change_delay
             << " seconds." << std::endl;
 
+  if (AdaptiveLifetime || LossRate > 0.0) rtt_estimator.Report();
+
   return 0;
 }
 
@@ -15,6 +15,8 @@
 #include "ns3/point-to-point-module.h"
 #include "ns3/random-variable-stream.h"
 
+#include "forwarder-pressure-tracer.hpp"
+
 NS_LOG_COMPONENT_DEFINE("ns3.ndn.vsync.scenarios.Line");
 
 namespace ns3 {
@@ -59,6 +61,7 @@ int main(int argc, char* argv[]) {
   bool Synchronized = false;
   int LinkDelayMS = 10;
   double DataRate = 1.0;
+  double CsPitSamplePeriod = 0.0;
 
   CommandLine cmd;
   cmd.AddValue("NumOfNodes", "Number of sync nodes in the group (>= 2)", N);
@@ -73,6 +76,9 @@ int main(int argc, char* argv[]) {
                LinkDelayMS);
   cmd.AddValue("DataRate", "Data publishing rate (packets per second)",
                DataRate);
+  cmd.AddValue("CsPitSamplePeriod",
+               "CS and PIT sampling period in seconds (default 0, disabled)",
+               CsPitSamplePeriod);
   cmd.Parse(argc, argv);
 
   ::ndn::vsync::SetInterestLifetime(ndn::time::milliseconds(20 * LinkDelayMS),
@@ -102,16 +108,12 @@ int main(int argc, char* argv[]) {
   ndn::GlobalRoutingHelper ndnGlobalRoutingHelper;
   ndnGlobalRoutingHelper.InstallAll();
 
-  Ptr<UniformRandomVariable> seed = CreateObject<UniformRandomVariable>();
-  seed->SetAttribute("Min", DoubleValue(0.0));
-  seed->SetAttribute("Max", DoubleValue(1000.0));
-
   for (int i = 0; i < N; ++i) {
     ndn::AppHelper helper("ns3::ndn::vsync::SimpleNodeApp");
     std::string nid = "/N" + std::to_string(i);
     helper.SetAttribute("NodeID", StringValue(nid));
     if (!Synchronized)
-      helper.SetAttribute("RandomSeed", UintegerValue(seed->GetInteger()));
+      helper.SetAttribute("NodeIndex", UintegerValue(i));
     helper.Install(nodes.Get(i)).Start(Seconds(1.0));
     ndnGlobalRoutingHelper.AddOrigins(nid, nodes.Get(i));
 
@@ -140,12 +142,18 @@ int main(int argc, char* argv[]) {
 
   Simulator::Stop(Seconds(TotalRunTimeSeconds));
 
-  Simulator::Run();
-  Simulator::Destroy();
-
   std::string file_name =
       "results/LineD" + std::to_string(LinkDelayMS) + "N" + std::to_string(N);
   if (Synchronized) file_name += "Sync";
+  if (RngSeedManager::GetRun() != 1)
+    file_name += "Run" + std::to_string(RngSeedManager::GetRun());
+
+  if (CsPitSamplePeriod > 0.0)
+    ndn::vsync::ForwarderPressureTracer::InstallAll(
+        file_name + "-cs-pit-trace.txt", Seconds(CsPitSamplePeriod));
+
+  Simulator::Run();
+  Simulator::Destroy();
 
   std::fstream fs_sync_delay(file_name + "-sync-delay",
                              std::ios_base::out | std::ios_base::trunc);
@@ -0,0 +1,411 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/ndnSIM-module.h"
+
+#include "memory-forwarder.hpp"
+#include "node.hpp"
+#include "rng-stream.hpp"
+#include "spsc-ring.hpp"
+
+NS_LOG_COMPONENT_DEFINE("ns3.ndn.vsync.scenarios.LoadGenerator");
+
+namespace ns3 {
+
+using ::ndn::vsync::app::RngStream;
+using ::ndn::vsync::app::SpscRing;
+
+struct LoadConfig {
+  int N = 100;
+  double DataRate = 1.0;
+  double HotFraction = 0.0;
+  double HotRateMultiple = 10.0;
+  double DurationSeconds = 30.0;
+  int PayloadBytes = 100;
+  int DelayMS = 10;
+  int JitterMS = 5;
+  int LifetimeMS = 200;
+  bool Realtime = true;
+  int Shards = 1;
+  std::string Balance = "weighted";
+  int RingKB = 1024;
+  int PollUS = 200;
+};
+
+// Written by each shard and read by the parent after the shard exits.
+struct ShardStats {
+  uint64_t published;
+  uint64_t delivered;
+  uint64_t forwarded;
+  uint64_t ring_drops;
+  double wall;
+  double cpu;
+  long rss_before;
+  long rss_after;
+  long rss_end;
+};
+
+// Shared between the parent and the shards: one ring per ordered pair of
+// shards, ring (i, j) carrying packets from shard i to shard j.
+class RingMesh {
+ public:
+  RingMesh(int shards, std::size_t capacity)
+      : shards_(shards),
+        stride_((SpscRing::Footprint(capacity) + 63) / 64 * 64),
+        size_(stride_ * shards * shards + sizeof(ShardStats) * shards) {
+    memory_ = static_cast<uint8_t*>(mmap(nullptr, size_,
+                                         PROT_READ | PROT_WRITE,
+                                         MAP_SHARED | MAP_ANONYMOUS, -1, 0));
+    if (memory_ == MAP_FAILED)
+      throw std::runtime_error("Cannot map shared memory for the rings");
+    for (int i = 0; i < shards * shards; ++i)
+      SpscRing::Create(memory_ + stride_ * i, capacity);
+  }
+
+  ~RingMesh() { munmap(memory_, size_); }
+
+  SpscRing* Ring(int from, int to) {
+    return reinterpret_cast<SpscRing*>(memory_ +
+                                       stride_ * (from * shards_ + to));
+  }
+
+  ShardStats* Stats(int shard) {
+    return reinterpret_cast<ShardStats*>(memory_ +
+                                         stride_ * shards_ * shards_) +
+           shard;
+  }
+
+ private:
+  int shards_;
+  std::size_t stride_;
+  std::size_t size_;
+  uint8_t* memory_;
+};
+
+// One sync node on a DummyClientFace, publishing at a Poisson rate.
+struct LoadNode {
+  LoadNode(const std::string& nid, uint32_t index, double data_rate)
+      : face(std::make_shared<::ndn::util::DummyClientFace>(
+            ndn::StackHelper::getKeyChain(),
+            ::ndn::util::DummyClientFace::Options{false, true})),
+        scheduler(face->getIoService()),
+        node(*face, scheduler, ndn::StackHelper::getKeyChain(), nid,
+             RngStream(RngSeedManager::GetSeed(), RngSeedManager::GetRun(),
+                       index, RngStream::kProtocolJitter)()),
+        rengine(RngSeedManager::GetSeed(), RngSeedManager::GetRun(), index,
+                RngStream::kPublishTiming),
+        rdist(data_rate) {}
+
+  std::shared_ptr<::ndn::util::DummyClientFace> face;
+  ::ndn::Scheduler scheduler;
+  ::ndn::vsync::Node node;
+  RngStream rengine;
+  std::exponential_distribution<> rdist;
+};
+
+uint64_t published = 0;
+uint64_t delivered = 0;
+uint64_t ring_drops = 0;
+std::string payload;
+
+static void SchedulePublish(LoadNode* n) {
+  n->scheduler.scheduleEvent(
+      ndn::time::microseconds(static_cast<int64_t>(1e6 * n->rdist(n->rengine))),
+      [n] {
+        n->node.PublishData(payload);
+        ++published;
+        SchedulePublish(n);
+      });
+}
+
+// Resident set size of the process in KB.
+static long ResidentKB() {
+  long pages = 0;
+  std::ifstream statm("/proc/self/statm");
+  statm >> pages >> pages;
+  return pages * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+static double CpuSeconds() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+         (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+static std::string NodeName(int i) { return "/N" + std::to_string(i); }
+
+// Publishing rate of every node: the first HotFraction of them publish
+// HotRateMultiple times faster than the rest.
+static std::vector<double> NodeRates(const LoadConfig& c) {
+  std::vector<double> rates(c.N, c.DataRate);
+  int hot = static_cast<int>(c.HotFraction * c.N);
+  for (int i = 0; i < hot; ++i) rates[i] *= c.HotRateMultiple;
+  return rates;
+}
+
+// Assigns nodes to shards, either round robin or by publishing rate
+// (longest processing time first onto the least loaded shard).
+static std::vector<int> Partition(const LoadConfig& c,
+                                  const std::vector<double>& rates) {
+  std::vector<int> shard_of(c.N);
+  if (c.Balance == "round-robin") {
+    for (int i = 0; i < c.N; ++i) shard_of[i] = i % c.Shards;
+    return shard_of;
+  }
+
+  std::vector<int> order(c.N);
+  for (int i = 0; i < c.N; ++i) order[i] = i;
+  std::stable_sort(order.begin(), order.end(),
+                   [&](int a, int b) { return rates[a] > rates[b]; });
+  std::vector<double> load(c.Shards, 0.0);
+  for (int i : order) {
+    int s = std::min_element(load.begin(), load.end()) - load.begin();
+    shard_of[i] = s;
+    load[s] += rates[i];
+  }
+  return shard_of;
+}
+
+// The nodes of one shard, their forwarder and its ports to the other shards.
+class Shard {
+ public:
+  Shard(const LoadConfig& c, int shard, const std::vector<int>& shard_of,
+        RingMesh* mesh)
+      : config_(c),
+        shard_(shard),
+        mesh_(mesh),
+        forwarder_(MilliSeconds(c.DelayMS), MilliSeconds(c.JitterMS)),
+        ports_(c.Shards, 0) {
+    for (int t = 0; t < c.Shards; ++t) {
+      if (t == shard) continue;
+      SpscRing* ring = mesh->Ring(shard, t);
+      ports_[t] = forwarder_.AddPort([ring](const Block& wire) {
+        if (!ring->Push(wire.wire(), wire.size())) ++ring_drops;
+      });
+      forwarder_.AddRoute(::ndn::vsync::kSyncPrefix, ports_[t]);
+    }
+    for (int i = 0; i < c.N; ++i) {
+      if (shard_of[i] == shard)
+        members_.push_back(i);
+      else
+        forwarder_.AddRoute(NodeName(i), ports_[shard_of[i]]);
+    }
+  }
+
+  void Start(const std::vector<double>& rates) {
+    std::vector<::ndn::vsync::MemberInfo> mlist;
+    for (int i = 0; i < config_.N; ++i) mlist.push_back({NodeName(i)});
+    ::ndn::vsync::ViewInfo vinfo(mlist);
+    auto leader = vinfo.GetIDByIndex(vinfo.Size() - 1).first;
+
+    for (int i : members_) {
+      nodes_.emplace_back(new LoadNode(NodeName(i), i, rates[i]));
+      LoadNode* n = nodes_.back().get();
+      forwarder_.AddFace(n->face);
+      n->node.SetViewInfo({1, leader}, vinfo);
+      n->node.ConnectDataSignal(
+          [](std::shared_ptr<const ndn::Data>) { ++delivered; });
+      n->node.Start();
+      SchedulePublish(n);
+    }
+    if (mesh_ != nullptr) Poll();
+  }
+
+  void Stop() { nodes_.clear(); }
+
+  uint64_t Forwarded() const {
+    return forwarder_.GetForwardedInterests() +
+           forwarder_.GetForwardedData();
+  }
+
+ private:
+  void Poll() {
+    std::vector<uint8_t> record;
+    for (int t = 0; t < config_.Shards; ++t) {
+      if (t == shard_) continue;
+      SpscRing* ring = mesh_->Ring(t, shard_);
+      while (ring->Pop(record))
+        forwarder_.ReceiveFromPort(ports_[t],
+                                   Block(record.data(), record.size()));
+    }
+    Simulator::Schedule(MicroSeconds(config_.PollUS), &Shard::Poll, this);
+  }
+
+  const LoadConfig& config_;
+  int shard_;
+  RingMesh* mesh_;
+  ndn::vsync::MemoryForwarder forwarder_;
+  std::vector<std::size_t> ports_;
+  std::vector<int> members_;
+  std::vector<std::unique_ptr<LoadNode>> nodes_;
+};
+
+static void RunShard(const LoadConfig& c, int shard,
+                     const std::vector<int>& shard_of,
+                     const std::vector<double>& rates, RingMesh* mesh,
+                     ShardStats* stats) {
+  if (c.Realtime)
+    GlobalValue::Bind("SimulatorImplementationType",
+                      StringValue("ns3::RealtimeSimulatorImpl"));
+
+  ::ndn::vsync::SetInterestLifetime(ndn::time::milliseconds(c.LifetimeMS),
+                                    ndn::time::milliseconds(c.LifetimeMS));
+  ::ndn::vsync::SetHeartbeatInterval(
+      ndn::time::milliseconds(static_cast<int>(1000.0 / c.DataRate)));
+
+  payload.assign(c.PayloadBytes, 'x');
+
+  stats->rss_before = ResidentKB();
+  Shard s(c, shard, shard_of, mesh);
+  s.Start(rates);
+  stats->rss_after = ResidentKB();
+
+  Simulator::Stop(Seconds(c.DurationSeconds));
+
+  double cpu_start = CpuSeconds();
+  auto wall_start = std::chrono::steady_clock::now();
+  Simulator::Run();
+  stats->wall = std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - wall_start)
+                    .count();
+  stats->cpu = CpuSeconds() - cpu_start;
+  stats->rss_end = ResidentKB();
+
+  stats->published = published;
+  stats->delivered = delivered;
+  stats->forwarded = s.Forwarded();
+  stats->ring_drops = ring_drops;
+
+  s.Stop();
+  Simulator::Destroy();
+}
+
+int main(int argc, char* argv[]) {
+  LoadConfig c;
+
+  CommandLine cmd;
+  cmd.AddValue("NumOfNodes", "Number of sync nodes in the process", c.N);
+  cmd.AddValue("DataRate", "Publishing rate of each node (messages/second)",
+               c.DataRate);
+  cmd.AddValue("HotFraction",
+               "Fraction of nodes publishing HotRateMultiple times faster",
+               c.HotFraction);
+  cmd.AddValue("HotRateMultiple", "Rate multiple of the hot publishers",
+               c.HotRateMultiple);
+  cmd.AddValue("DurationSeconds", "Length of the run in seconds",
+               c.DurationSeconds);
+  cmd.AddValue("PayloadBytes", "Size of each message", c.PayloadBytes);
+  cmd.AddValue("DelayMS", "One-way delay of the in-memory forwarder in ms",
+               c.DelayMS);
+  cmd.AddValue("JitterMS", "Uniform jitter added to every delivery in ms",
+               c.JitterMS);
+  cmd.AddValue("LifetimeMS", "Sync and data interest lifetime in ms",
+               c.LifetimeMS);
+  cmd.AddValue("Realtime",
+               "If set, run against the wall clock; otherwise as fast as "
+               "possible (single shard only)",
+               c.Realtime);
+  cmd.AddValue("Shards", "Number of worker processes the nodes are split "
+                         "across",
+               c.Shards);
+  cmd.AddValue("Balance",
+               "Node placement: weighted (by publishing rate) or round-robin",
+               c.Balance);
+  cmd.AddValue("RingKB", "Capacity of each inter-shard ring in KB", c.RingKB);
+  cmd.AddValue("PollUS", "Inter-shard ring polling period in microseconds",
+               c.PollUS);
+  cmd.Parse(argc, argv);
+
+  if (c.Balance != "weighted" && c.Balance != "round-robin") {
+    std::cerr << "Unknown balance mode: " << c.Balance << std::endl;
+    return -1;
+  }
+  c.Shards = std::max(1, std::min(c.Shards, c.N));
+  // Shards only share a time base through the wall clock.
+  if (c.Shards > 1) c.Realtime = true;
+
+  std::vector<double> rates = NodeRates(c);
+  std::vector<int> shard_of = Partition(c, rates);
+
+  std::vector<ShardStats> stats(c.Shards);
+  if (c.Shards == 1) {
+    RunShard(c, 0, shard_of, rates, nullptr, &stats[0]);
+  } else {
+    RingMesh mesh(c.Shards, static_cast<std::size_t>(c.RingKB) * 1024);
+    std::vector<pid_t> workers;
+    for (int s = 0; s < c.Shards; ++s) {
+      pid_t pid = fork();
+      if (pid == 0) {
+        RunShard(c, s, shard_of, rates, &mesh, mesh.Stats(s));
+        _exit(0);
+      }
+      if (pid < 0) {
+        std::cerr << "Cannot start shard " << s << std::endl;
+        return -1;
+      }
+      workers.push_back(pid);
+    }
+    for (pid_t pid : workers) waitpid(pid, nullptr, 0);
+    for (int s = 0; s < c.Shards; ++s) stats[s] = *mesh.Stats(s);
+  }
+
+  ShardStats total{};
+  for (const auto& s : stats) {
+    total.published += s.published;
+    total.delivered += s.delivered;
+    total.forwarded += s.forwarded;
+    total.ring_drops += s.ring_drops;
+    total.wall = std::max(total.wall, s.wall);
+    total.cpu += s.cpu;
+    total.rss_after += s.rss_after - s.rss_before;
+    total.rss_end += s.rss_end - s.rss_before;
+  }
+
+  std::cout << "Number of shards is: " << c.Shards << std::endl;
+  std::cout << "Total number of messages published is: " << total.published
+            << std::endl;
+  std::cout << "Total number of messages delivered is: " << total.delivered
+            << std::endl;
+  std::cout << "Wall clock time is: " << total.wall << " seconds."
+            << std::endl;
+  std::cout << "Simulated time per wall clock second is: "
+            << c.DurationSeconds / total.wall << std::endl;
+  std::cout << "Messages delivered per second is: "
+            << total.delivered / total.wall << std::endl;
+  if (total.delivered > 0)
+    std::cout << "CPU time per delivered message is: "
+              << 1e6 * total.cpu / total.delivered << " microseconds."
+              << std::endl;
+  std::cout << "Memory per node at start is: "
+            << static_cast<double>(total.rss_after) / c.N << " KB."
+            << std::endl;
+  std::cout << "Memory per node at end is: "
+            << static_cast<double>(total.rss_end) / c.N << " KB."
+            << std::endl;
+  std::cout << "Packets forwarded is: " << total.forwarded << std::endl;
+  if (c.Shards > 1)
+    std::cout << "Packets dropped on full rings is: " << total.ring_drops
+              << std::endl;
+
+  return 0;
+}
+
+}  // namespace ns3
+
+int main(int argc, char* argv[]) { return ns3::main(argc, argv); }
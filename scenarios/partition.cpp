@@ -0,0 +1,385 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#include "simple-app.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/ndnSIM-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+
+#include "traffic-counter.hpp"
+
+NS_LOG_COMPONENT_DEFINE("ns3.ndn.vsync.scenarios.Partition");
+
+namespace ns3 {
+
+using ndn::vsync::TrafficCounter;
+
+std::unordered_map<std::string, std::pair<double, std::vector<double>>> delays;
+
+static void DataEvent(std::string nid, std::shared_ptr<const ndn::Data> data,
+                      bool is_local) {
+  double now = Simulator::Now().GetSeconds();
+  auto& entry = delays[data->getName().toUri()];
+  if (is_local)
+    entry.first = now;
+  else
+    entry.second.push_back(now);
+}
+
+// Side of the partition of every member, and the size of every view each
+// member installed, in order.
+std::map<std::string, char> sides;
+std::map<std::string, std::vector<std::pair<double, std::size_t>>> views;
+std::set<::ndn::vsync::ViewID, ::ndn::vsync::VIDCompare> reported_views;
+
+static void ViewChange(std::string nid, const ::ndn::vsync::ViewID& vid,
+                       const ::ndn::vsync::ViewInfo& vinfo, bool is_leader) {
+  double now = Simulator::Now().GetSeconds();
+  views[nid].emplace_back(now, vinfo.Size());
+  if (!reported_views.insert(vid).second) return;
+  std::cout << now << "s: view " << vid << " of " << vinfo.Size()
+            << " members, first installed by " << nid << " on side "
+            << sides[nid] << std::endl;
+}
+
+// Traffic totals once a second, to split the bytes of the heal phase off.
+std::vector<std::pair<double, uint64_t>> traffic_samples;
+
+static void SampleTraffic() {
+  traffic_samples.emplace_back(Simulator::Now().GetSeconds(),
+                               TrafficCounter::GetTotalBytes());
+  Simulator::Schedule(Seconds(1.0), &SampleTraffic);
+}
+
+static uint64_t BytesAt(double t) {
+  uint64_t bytes = 0;
+  for (const auto& s : traffic_samples) {
+    if (s.first > t) break;
+    bytes = s.second;
+  }
+  return bytes;
+}
+
+// Cut links drop every packet; the others keep the configured loss rate.
+static void SetErrorModel(const std::vector<Ptr<NetDevice>>& devices,
+                          Ptr<ErrorModel> model) {
+  for (const auto& device : devices)
+    device->SetAttribute("ReceiveErrorModel", PointerValue(model));
+}
+
+static std::string NodeName(Ptr<Node> node) { return Names::FindName(node); }
+
+// Grows two regions breadth-first from |a| and |b|, one node at a time
+// each, so every node ends up on the side it is closer to.
+static std::map<uint32_t, char> SplitTopology(Ptr<Node> a, Ptr<Node> b) {
+  std::map<uint32_t, char> side{{a->GetId(), 'A'}, {b->GetId(), 'B'}};
+  std::deque<Ptr<Node>> queues[2] = {{a}, {b}};
+  while (!queues[0].empty() || !queues[1].empty()) {
+    for (int k = 0; k < 2; ++k) {
+      if (queues[k].empty()) continue;
+      Ptr<Node> node = queues[k].front();
+      queues[k].pop_front();
+      for (uint32_t i = 0; i < node->GetNDevices(); ++i) {
+        Ptr<Channel> channel = node->GetDevice(i)->GetChannel();
+        if (channel == nullptr) continue;
+        for (std::size_t j = 0; j < channel->GetNDevices(); ++j) {
+          Ptr<Node> peer = channel->GetDevice(j)->GetNode();
+          if (side.emplace(peer->GetId(), 'A' + k).second)
+            queues[k].push_back(peer);
+        }
+      }
+    }
+  }
+  return side;
+}
+
+int main(int argc, char* argv[]) {
+  Config::SetDefault("ns3::DropTailQueue::MaxPackets", StringValue("100"));
+
+  std::string Topology = "campus";
+  double TotalRunTimeSeconds = 120.0;
+  double PartitionStartSeconds = 30.0;
+  double PartitionEndSeconds = 60.0;
+  std::string CutLinks = "";
+  double LossRate = 0.0;
+  double DataRate = 1.0;
+
+  CommandLine cmd;
+  cmd.AddValue("Topology", "campus or 6461", Topology);
+  cmd.AddValue("TotalRunTimeSeconds",
+               "Total running time of the simulation in seconds",
+               TotalRunTimeSeconds);
+  cmd.AddValue("PartitionStartSeconds", "When the links are cut",
+               PartitionStartSeconds);
+  cmd.AddValue("PartitionEndSeconds", "When the links are restored",
+               PartitionEndSeconds);
+  cmd.AddValue("CutLinks",
+               "Comma-separated node pairs to disconnect, e.g. bb1:bb2 (by "
+               "default a fixed cut of campus, or a split of 6461 between "
+               "the first and the sixth member)",
+               CutLinks);
+  cmd.AddValue("LossRate", "Packet loss rate in the network", LossRate);
+  cmd.AddValue("DataRate", "Data publishing rate (packets per second)",
+               DataRate);
+  cmd.Parse(argc, argv);
+
+  std::vector<std::string> members;
+  std::string topology_file;
+  if (Topology == "campus") {
+    topology_file = "topologies/campus.txt";
+    for (int i = 1; i <= 10; ++i) members.push_back('n' + std::to_string(i));
+    if (CutLinks.empty()) CutLinks = "bb1:bb2,bb1:dr2,dr3:gw6,dr3:gw7";
+  } else if (Topology == "6461") {
+    topology_file = "topologies/6461.r0-conv-annotated.txt";
+    members = {"leaf-505", "leaf-687", "leaf-741", "leaf-580", "leaf-463",
+               "leaf-721", "leaf-486", "leaf-675", "leaf-799", "leaf-525"};
+    ::ndn::vsync::SetInterestLifetime(ndn::time::milliseconds(500),
+                                      ndn::time::milliseconds(500));
+  } else {
+    std::cerr << "Unknown topology: " << Topology << std::endl;
+    return -1;
+  }
+
+  ::ndn::vsync::SetHeartbeatInterval(
+      ndn::time::milliseconds(static_cast<int>(1000.0 / DataRate)));
+
+  AnnotatedTopologyReader topologyReader("", 25);
+  topologyReader.SetFileName(topology_file);
+  topologyReader.Read();
+
+  ndn::StackHelper ndnHelper;
+  ndnHelper.setCsSize(2000);
+  ndnHelper.InstallAll();
+
+  ndn::GlobalRoutingHelper ndnGlobalRoutingHelper;
+  ndnGlobalRoutingHelper.InstallAll();
+
+  ndn::StrategyChoiceHelper::InstallAll(::ndn::vsync::kSyncPrefix,
+                                        "/localhost/nfd/strategy/multicast");
+
+  Ptr<RateErrorModel> rem = CreateObject<RateErrorModel>();
+  rem->SetAttribute("ErrorRate", DoubleValue(LossRate));
+  rem->SetAttribute("ErrorUnit", StringValue("ERROR_UNIT_PACKET"));
+  Config::Set(
+      "/NodeList/*/DeviceList/*/$ns3::PointToPointNetDevice/ReceiveErrorModel",
+      PointerValue(rem));
+  Ptr<RateErrorModel> cut = CreateObject<RateErrorModel>();
+  cut->SetAttribute("ErrorRate", DoubleValue(1.0));
+  cut->SetAttribute("ErrorUnit", StringValue("ERROR_UNIT_PACKET"));
+
+  // Every device on a link between two nodes of a cut pair, or, without
+  // explicit pairs, between the two sides of the split.
+  std::set<std::pair<std::string, std::string>> pairs;
+  std::map<uint32_t, char> split;
+  std::istringstream cut_list(CutLinks);
+  std::string pair;
+  while (std::getline(cut_list, pair, ',')) {
+    auto colon = pair.find(':');
+    if (colon == std::string::npos) {
+      std::cerr << "Invalid link: " << pair << std::endl;
+      return -1;
+    }
+    pairs.emplace(pair.substr(0, colon), pair.substr(colon + 1));
+    pairs.emplace(pair.substr(colon + 1), pair.substr(0, colon));
+  }
+  if (pairs.empty())
+    split = SplitTopology(Names::Find<Node>(members[0]),
+                          Names::Find<Node>(members[5]));
+
+  std::vector<Ptr<NetDevice>> cut_devices;
+  std::size_t cut_links = 0;
+  for (auto node = NodeList::Begin(); node != NodeList::End(); ++node) {
+    for (uint32_t i = 0; i < (*node)->GetNDevices(); ++i) {
+      Ptr<NetDevice> device = (*node)->GetDevice(i);
+      Ptr<Channel> channel = device->GetChannel();
+      if (channel == nullptr || channel->GetNDevices() != 2) continue;
+      Ptr<Node> peer = channel->GetDevice(0) == device
+                           ? channel->GetDevice(1)->GetNode()
+                           : channel->GetDevice(0)->GetNode();
+      bool is_cut =
+          pairs.empty()
+              ? split[(*node)->GetId()] != split[peer->GetId()]
+              : pairs.count({NodeName(*node), NodeName(peer)}) > 0;
+      if (!is_cut) continue;
+      cut_devices.push_back(device);
+      if ((*node)->GetId() < peer->GetId()) ++cut_links;
+    }
+  }
+  std::cout << "Cutting " << cut_links << " links from "
+            << PartitionStartSeconds << "s to " << PartitionEndSeconds << "s"
+            << std::endl;
+  Simulator::Schedule(Seconds(PartitionStartSeconds), &SetErrorModel,
+                      cut_devices, cut);
+  Simulator::Schedule(Seconds(PartitionEndSeconds), &SetErrorModel,
+                      cut_devices, rem);
+
+  // Members reachable from the first one while the links are down are on
+  // side A, the others on side B.
+  {
+    Ptr<Node> first = Names::Find<Node>(members[0]);
+    std::set<uint32_t> reached{first->GetId()};
+    std::deque<Ptr<Node>> queue{first};
+    std::set<Ptr<NetDevice>> down(cut_devices.begin(), cut_devices.end());
+    while (!queue.empty()) {
+      Ptr<Node> node = queue.front();
+      queue.pop_front();
+      for (uint32_t i = 0; i < node->GetNDevices(); ++i) {
+        Ptr<NetDevice> device = node->GetDevice(i);
+        Ptr<Channel> channel = device->GetChannel();
+        if (channel == nullptr || down.count(device) > 0) continue;
+        for (std::size_t j = 0; j < channel->GetNDevices(); ++j) {
+          Ptr<Node> peer = channel->GetDevice(j)->GetNode();
+          if (reached.insert(peer->GetId()).second)
+            queue.push_back(peer);
+        }
+      }
+    }
+    for (const auto& nid : members)
+      sides[nid] = reached.count(Names::Find<Node>(nid)->GetId()) ? 'A' : 'B';
+  }
+
+  std::vector<::ndn::vsync::MemberInfo> mlist;
+  for (const auto& nid : members) mlist.push_back({::ndn::Name('/' + nid)});
+  ::ndn::vsync::ViewInfo vinfo(mlist);
+  std::string vinfo_proto;
+  vinfo.Encode(vinfo_proto);
+
+  for (std::size_t i = 0; i < members.size(); ++i) {
+    const std::string& nid = members[i];
+    Ptr<Node> node = Names::Find<Node>(nid);
+    std::cout << "node /" << nid << " is on side " << sides[nid] << std::endl;
+
+    ndn::AppHelper helper("ns3::ndn::vsync::SimpleNodeApp");
+    helper.SetAttribute("NodeID", StringValue('/' + nid));
+    helper.SetAttribute("ViewInfo", StringValue(vinfo_proto));
+    helper.SetAttribute("StartTime", TimeValue(Seconds(1.0)));
+    helper.SetAttribute("StopTime", TimeValue(Seconds(TotalRunTimeSeconds)));
+    helper.SetAttribute("DataRate", DoubleValue(DataRate));
+    helper.SetAttribute("NodeIndex", UintegerValue(i + 1));
+    // Keep publishing for the whole run.
+    helper.SetAttribute(
+        "MaxDataCount",
+        UintegerValue(static_cast<uint32_t>(DataRate * TotalRunTimeSeconds) +
+                      100));
+    helper.Install(node);
+
+    ndnGlobalRoutingHelper.AddOrigins('/' + nid, node);
+    ndnGlobalRoutingHelper.AddOrigins(::ndn::vsync::kSyncPrefix.toUri(), node);
+
+    node->GetApplication(0)->TraceConnect("DataEvent", nid,
+                                          MakeCallback(&DataEvent));
+    node->GetApplication(0)->TraceConnect("ViewChange", nid,
+                                          MakeCallback(&ViewChange));
+  }
+
+  ndn::GlobalRoutingHelper::CalculateRoutes();
+
+  TrafficCounter::InstallAll();
+  Simulator::Schedule(Seconds(0.0), &SampleTraffic);
+
+  Simulator::Stop(Seconds(TotalRunTimeSeconds));
+
+  std::string file_name = "results/VS-Partition-" + Topology + "T" +
+                          std::to_string(PartitionStartSeconds) + "-" +
+                          std::to_string(PartitionEndSeconds);
+  if (LossRate > 0.0) file_name += "LR" + std::to_string(LossRate);
+  if (DataRate != 1.0) file_name += "DR" + std::to_string(DataRate);
+  if (RngSeedManager::GetRun() != 1)
+    file_name += "Run" + std::to_string(RngSeedManager::GetRun());
+
+  ndn::L3RateTracer::InstallAll(file_name + "-rate-trace.txt", Seconds(1.0));
+
+  Simulator::Run();
+  Simulator::Destroy();
+
+  // Reconciled once every item published before the heal reached every
+  // other member; items published during the split reach the other side
+  // only after it.
+  std::size_t split_items = 0;
+  std::size_t missing = 0;
+  double reconciled = PartitionEndSeconds;
+  for (const auto& entry : delays) {
+    double gen_time = entry.second.first;
+    const auto& vec = entry.second.second;
+    if (gen_time >= PartitionEndSeconds) continue;
+    if (gen_time >= PartitionStartSeconds) ++split_items;
+    if (vec.size() != members.size() - 1) {
+      ++missing;
+      continue;
+    }
+    reconciled =
+        std::max(reconciled, *std::max_element(vec.begin(), vec.end()));
+  }
+
+  // The views are merged again once every member has installed a view of
+  // the whole group after the heal.
+  double merged = PartitionEndSeconds;
+  int split_view_changes = 0;
+  int heal_view_changes = 0;
+  for (const auto& member : views) {
+    double member_merged = -1.0;
+    std::size_t size_at_heal = members.size();
+    for (const auto& v : member.second) {
+      if (v.first < PartitionStartSeconds) {
+        size_at_heal = v.second;
+        continue;
+      }
+      if (v.first < PartitionEndSeconds) {
+        ++split_view_changes;
+        size_at_heal = v.second;
+        continue;
+      }
+      ++heal_view_changes;
+      if (member_merged < 0.0 && v.second == members.size())
+        member_merged = v.first;
+    }
+    if (member_merged < 0.0 && size_at_heal == members.size())
+      member_merged = PartitionEndSeconds;
+    if (member_merged < 0.0) {
+      merged = -1.0;
+      break;
+    }
+    merged = std::max(merged, member_merged);
+  }
+
+  std::cout << "Total number of data published is: " << delays.size()
+            << std::endl;
+  std::cout << "Data published during the partition is: " << split_items
+            << std::endl;
+  std::cout << "Data not reconciled is: " << missing << std::endl;
+  if (missing == 0) {
+    std::cout << "Time to full reconciliation is: "
+              << reconciled - PartitionEndSeconds << " seconds." << std::endl;
+    // Up to the traffic sample after reconciliation.
+    uint64_t bytes = BytesAt(reconciled + 1.0) - BytesAt(PartitionEndSeconds);
+    std::cout << "Bytes exchanged during reconciliation is: " << bytes
+              << std::endl;
+  }
+  std::cout << "View changes during partition is: " << split_view_changes
+            << std::endl;
+  std::cout << "View changes after heal is: " << heal_view_changes
+            << std::endl;
+  if (merged >= 0.0)
+    std::cout << "Time to merged view is: " << merged - PartitionEndSeconds
+              << " seconds." << std::endl;
+  else
+    std::cout << "Views were not merged by the end of the run" << std::endl;
+
+  return 0;
+}
+
+}  // namespace ns3
+
+int main(int argc, char* argv[]) { return ns3::main(argc, argv); }
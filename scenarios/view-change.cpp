@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <set>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -29,6 +30,28 @@ static void NodeStop(std::string nid) {
   NS_LOG_INFO("node /" << nid << " stops");
 }
 
+// Publish time of every data item, and delivery times at joining nodes.
+std::unordered_map<std::string, double> publish_times;
+std::set<std::string> joiners;
+std::unordered_map<std::string, std::unordered_map<std::string, double>>
+    joiner_deliveries;
+
+static void DataEvent(std::string nid, std::shared_ptr<const ndn::Data> data,
+                      bool is_local) {
+  double now = Simulator::Now().GetSeconds();
+  auto name = data->getName().toUri();
+  if (is_local)
+    publish_times[name] = now;
+  else if (joiners.count(nid) > 0)
+    joiner_deliveries[nid].emplace(name, now);
+}
+
+static void Snapshot(std::string nid, std::size_t items, Time duration) {
+  std::cout << "node " << nid << " loaded " << items
+            << " items from a snapshot in " << duration.GetSeconds()
+            << " seconds" << std::endl;
+}
+
 int main(int argc, char* argv[]) {
   Config::SetDefault("ns3::DropTailQueue::MaxPackets", StringValue("100"));
 
@@ -39,6 +62,11 @@ int main(int argc, char* argv[]) {
   std::string LinkDelay = "100ms";
   int LeavingNodes = 0;
   double DataRate = 1.0;
+  int MaxDataCount = 100;
+  int JoiningNodes = 0;
+  double JoinTimeSeconds = 20.0;
+  int SnapshotHorizon = 0;
+  int SnapshotWindow = 8;
 
   ::ndn::vsync::SetInterestLifetime(ndn::time::milliseconds(100),
                                     ndn::time::milliseconds(100));
@@ -60,8 +88,33 @@ int main(int argc, char* argv[]) {
                LeavingNodes);
   cmd.AddValue("DataRate", "Data publishing rate (packets per second)",
                DataRate);
+  cmd.AddValue("MaxDataCount", "Number of messages each node generates",
+               MaxDataCount);
+  cmd.AddValue("JoiningNodes",
+               "Number of nodes outside the initial view that start at "
+               "JoinTimeSeconds",
+               JoiningNodes);
+  cmd.AddValue("JoinTimeSeconds", "When the joining nodes start",
+               JoinTimeSeconds);
+  cmd.AddValue("SnapshotHorizon",
+               "Recent items each node serves as a snapshot to joiners (0 "
+               "for item-by-item backfill through sync)",
+               SnapshotHorizon);
+  cmd.AddValue("SnapshotWindow",
+               "Snapshot segment interests a joiner keeps in flight",
+               SnapshotWindow);
   cmd.Parse(argc, argv);
 
+  if (LeavingNodes + JoiningNodes >= 10) {
+    std::cerr << "Leaving and joining nodes must leave one member to "
+                 "bootstrap from"
+              << std::endl;
+    return -1;
+  }
+  // Joiners load their snapshot from the first member that neither joins
+  // nor leaves.
+  std::string bootstrap_peer = "/n" + std::to_string(LeavingNodes + 1);
+
   Config::SetDefault("ns3::PointToPointChannel::Delay", StringValue(LinkDelay));
 
   AnnotatedTopologyReader topologyReader("", 25);
@@ -80,10 +133,6 @@ int main(int argc, char* argv[]) {
   ndn::StrategyChoiceHelper::InstallAll(::ndn::vsync::kSyncPrefix,
                                         "/localhost/nfd/strategy/multicast");
 
-  Ptr<UniformRandomVariable> seed = CreateObject<UniformRandomVariable>();
-  seed->SetAttribute("Min", DoubleValue(0.0));
-  seed->SetAttribute("Max", DoubleValue(1000.0));
-
   Ptr<UniformRandomVariable> stop_time = CreateObject<UniformRandomVariable>();
   stop_time->SetAttribute("Min", DoubleValue(20.0));
   stop_time->SetAttribute("Max", DoubleValue(TotalRunTimeSeconds));
@@ -97,8 +146,10 @@ int main(int argc, char* argv[]) {
       "/NodeList/*/DeviceList/*/$ns3::PointToPointNetDevice/ReceiveErrorModel",
       PointerValue(rem));
 
+  // Joiners are not in the initial view; they start alone and are taken in
+  // by a view change once they run.
   std::vector<::ndn::vsync::MemberInfo> mlist;
-  for (int i = 1; i <= 10; ++i) {
+  for (int i = 1; i <= 10 - JoiningNodes; ++i) {
     std::string nid = 'n' + std::to_string(i);
     mlist.push_back({::ndn::Name('/' + nid)});
   }
@@ -112,8 +163,19 @@ int main(int argc, char* argv[]) {
 
     ndn::AppHelper helper("ns3::ndn::vsync::SimpleNodeApp");
     helper.SetAttribute("NodeID", StringValue('/' + nid));
-    helper.SetAttribute("ViewInfo", StringValue(vinfo_proto));
-    helper.SetAttribute("StartTime", TimeValue(Seconds(1.0)));
+    if (i > 10 - JoiningNodes) {
+      joiners.insert(nid);
+      helper.SetAttribute("StartTime", TimeValue(Seconds(JoinTimeSeconds)));
+      if (SnapshotHorizon > 0)
+        helper.SetAttribute("BootstrapPeer", StringValue(bootstrap_peer));
+    } else {
+      helper.SetAttribute("ViewInfo", StringValue(vinfo_proto));
+      helper.SetAttribute("StartTime", TimeValue(Seconds(1.0)));
+    }
+    if (SnapshotHorizon > 0) {
+      helper.SetAttribute("SnapshotHorizon", UintegerValue(SnapshotHorizon));
+      helper.SetAttribute("SnapshotWindow", UintegerValue(SnapshotWindow));
+    }
     if (i <= LeavingNodes) {
       double st = stop_time->GetValue();
       Simulator::Schedule(Seconds(st), NodeStop, nid);
@@ -122,8 +184,9 @@ int main(int argc, char* argv[]) {
       helper.SetAttribute("StopTime", TimeValue(Seconds(TotalRunTimeSeconds)));
     }
     helper.SetAttribute("DataRate", DoubleValue(DataRate));
+    helper.SetAttribute("MaxDataCount", UintegerValue(MaxDataCount));
     if (!Synchronized)
-      helper.SetAttribute("RandomSeed", UintegerValue(seed->GetInteger()));
+      helper.SetAttribute("NodeIndex", UintegerValue(i));
     helper.Install(node);
 
     ndnGlobalRoutingHelper.AddOrigins('/' + nid, node);
@@ -131,6 +194,10 @@ int main(int argc, char* argv[]) {
 
     node->GetApplication(0)->TraceConnect("ViewChange", nid,
                                           MakeCallback(&ViewChange));
+    node->GetApplication(0)->TraceConnect("DataEvent", nid,
+                                          MakeCallback(&DataEvent));
+    node->GetApplication(0)->TraceConnect("Snapshot", nid,
+                                          MakeCallback(&Snapshot));
   }
 
   ndn::GlobalRoutingHelper::CalculateRoutes();
@@ -151,6 +218,54 @@ int main(int argc, char* argv[]) {
   Simulator::Run();
   Simulator::Destroy();
 
+  // A joiner is fully synced once it holds every item published before it
+  // joined. Those items belong to earlier views, so without a snapshot a
+  // joiner may never get them.
+  if (JoiningNodes > 0) {
+    double history = 0.0;
+    double sync_time = 0.0;
+    double max_sync_time = 0.0;
+    int synced = 0;
+    for (const auto& nid : joiners) {
+      const auto& delivered = joiner_deliveries[nid];
+      int items = 0;
+      int missing = 0;
+      double last = JoinTimeSeconds;
+      for (const auto& item : publish_times) {
+        if (item.second >= JoinTimeSeconds) continue;
+        ++items;
+        auto iter = delivered.find(item.first);
+        if (iter == delivered.end())
+          ++missing;
+        else
+          last = std::max(last, iter->second);
+      }
+      history += items;
+      if (missing > 0) {
+        std::cout << "node " << nid << ": history " << items << " items, "
+                  << missing << " missing" << std::endl;
+        continue;
+      }
+      double t = last - JoinTimeSeconds;
+      std::cout << "node " << nid << ": history " << items
+                << " items, fully synced after " << t << " seconds"
+                << std::endl;
+      ++synced;
+      sync_time += t;
+      max_sync_time = std::max(max_sync_time, t);
+    }
+    std::cout << "History length is: " << history / joiners.size()
+              << " items." << std::endl;
+    std::cout << "Joiners not fully synced is: " << joiners.size() - synced
+              << std::endl;
+    if (synced > 0) {
+      std::cout << "Average time to fully synced is: " << sync_time / synced
+                << " seconds." << std::endl;
+      std::cout << "Max time to fully synced is: " << max_sync_time
+                << " seconds." << std::endl;
+    }
+  }
+
   // int count = 0;
   // double average_delay = std::accumulate(
   //     delays.begin(), delays.end(), 0.0,
@@ -0,0 +1,203 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#include "simple-app.hpp"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/ndnSIM-module.h"
+#include "ns3/network-module.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/wifi-module.h"
+
+#include "sync-metrics.hpp"
+#include "traffic-counter.hpp"
+
+NS_LOG_COMPONENT_DEFINE("ns3.ndn.vsync.scenarios.WifiAdhoc");
+
+namespace ns3 {
+
+// Airtime of |packets| broadcast frames carrying |bytes| of NDN packets at
+// |rate_mbps|. Broadcast frames are not acknowledged, so each one costs
+// DIFS, the mean backoff of an idle 802.11a channel, the PLCP preamble and
+// header, and its MAC framing (header, LLC/SNAP and FCS) plus payload at the
+// data rate.
+static double Airtime(uint64_t packets, uint64_t bytes, double rate_mbps) {
+  const double kPerFrameUs = 34.0 + 67.5 + 20.0;
+  const int kMacFramingBytes = 24 + 8 + 4;
+  return (packets * kPerFrameUs +
+          (bytes + packets * kMacFramingBytes) * 8 / rate_mbps) /
+         1e6;
+}
+
+int main(int argc, char* argv[]) {
+  int N = 20;
+  double AreaSide = 100.0;
+  double MaxSpeed = 0.0;
+  double PauseSeconds = 2.0;
+  double TotalRunTimeSeconds = 100.0;
+  bool Synchronized = false;
+  double DataRate = 1.0;
+  int LifetimeMS = 100;
+
+  CommandLine cmd;
+  cmd.AddValue("NumOfNodes", "Number of sync nodes in the group", N);
+  cmd.AddValue("AreaSide", "Side of the square area in meters", AreaSide);
+  cmd.AddValue("MaxSpeed",
+               "Maximum random waypoint speed in m/s (0 for static nodes)",
+               MaxSpeed);
+  cmd.AddValue("PauseSeconds", "Random waypoint pause time in seconds",
+               PauseSeconds);
+  cmd.AddValue("TotalRunTimeSeconds",
+               "Total running time of the simulation in seconds",
+               TotalRunTimeSeconds);
+  cmd.AddValue(
+      "Synchronized",
+      "If set, the data publishing events from all nodes are synchronized",
+      Synchronized);
+  cmd.AddValue("DataRate", "Data publishing rate (packets per second)",
+               DataRate);
+  cmd.AddValue("LifetimeMS", "Sync and data interest lifetime in ms",
+               LifetimeMS);
+  cmd.Parse(argc, argv);
+
+  ::ndn::vsync::SetInterestLifetime(ndn::time::milliseconds(LifetimeMS),
+                                    ndn::time::milliseconds(LifetimeMS));
+
+  ::ndn::vsync::SetHeartbeatInterval(
+      ndn::time::milliseconds(static_cast<int>(1000.0 / DataRate)));
+
+  NodeContainer nodes;
+  nodes.Create(N);
+
+  const double kWifiRateMbps = 24.0;
+  WifiHelper wifi;
+  wifi.SetStandard(WIFI_PHY_STANDARD_80211a);
+  wifi.SetRemoteStationManager("ns3::ConstantRateWifiManager", "DataMode",
+                               StringValue("OfdmRate24Mbps"));
+
+  YansWifiChannelHelper wifiChannel;
+  wifiChannel.SetPropagationDelay("ns3::ConstantSpeedPropagationDelayModel");
+  wifiChannel.AddPropagationLoss("ns3::ThreeLogDistancePropagationLossModel");
+  wifiChannel.AddPropagationLoss("ns3::NakagamiPropagationLossModel");
+
+  YansWifiPhyHelper wifiPhyHelper = YansWifiPhyHelper::Default();
+  wifiPhyHelper.SetChannel(wifiChannel.Create());
+
+  NqosWifiMacHelper wifiMacHelper = NqosWifiMacHelper::Default();
+  wifiMacHelper.SetType("ns3::AdhocWifiMac");
+
+  wifi.Install(wifiPhyHelper, wifiMacHelper, nodes);
+
+  std::string area =
+      "ns3::UniformRandomVariable[Min=0.0|Max=" + std::to_string(AreaSide) +
+      "]";
+  ObjectFactory positions;
+  positions.SetTypeId("ns3::RandomRectanglePositionAllocator");
+  positions.Set("X", StringValue(area));
+  positions.Set("Y", StringValue(area));
+  Ptr<PositionAllocator> allocator =
+      positions.Create()->GetObject<PositionAllocator>();
+
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator(allocator);
+  if (MaxSpeed > 0.0) {
+    mobility.SetMobilityModel(
+        "ns3::RandomWaypointMobilityModel", "Speed",
+        StringValue("ns3::UniformRandomVariable[Min=0.1|Max=" +
+                    std::to_string(MaxSpeed) + "]"),
+        "Pause",
+        StringValue("ns3::ConstantRandomVariable[Constant=" +
+                    std::to_string(PauseSeconds) + "]"),
+        "PositionAllocator", PointerValue(allocator));
+  } else {
+    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+  }
+  mobility.Install(nodes);
+
+  // Every node has a single broadcast face, which is also its default
+  // route. The multicast strategy never sends an interest back out the face
+  // it came from, so sync interests reach the sender's radio neighborhood
+  // and are not relayed further.
+  ndn::StackHelper ndnHelper;
+  ndnHelper.SetDefaultRoutes(true);
+  ndnHelper.setCsSize(1000);
+  ndnHelper.InstallAll();
+
+  ndn::StrategyChoiceHelper::InstallAll("/",
+                                        "/localhost/nfd/strategy/multicast");
+
+  std::vector<::ndn::vsync::MemberInfo> mlist;
+  for (int i = 0; i < N; ++i)
+    mlist.push_back({::ndn::Name("/N" + std::to_string(i))});
+  ::ndn::vsync::ViewInfo vinfo(mlist);
+  std::string vinfo_proto;
+  vinfo.Encode(vinfo_proto);
+
+  ndn::vsync::SyncMetrics sync_metrics(N);
+
+  for (int i = 0; i < N; ++i) {
+    ndn::AppHelper helper("ns3::ndn::vsync::SimpleNodeApp");
+    std::string nid = "/N" + std::to_string(i);
+    helper.SetAttribute("NodeID", StringValue(nid));
+    helper.SetAttribute("ViewInfo", StringValue(vinfo_proto));
+    if (!Synchronized)
+      helper.SetAttribute("NodeIndex", UintegerValue(i));
+    helper.SetAttribute("DataRate", DoubleValue(DataRate));
+    helper.SetAttribute("StartTime", TimeValue(Seconds(1.0)));
+    helper.SetAttribute("StopTime", TimeValue(Seconds(TotalRunTimeSeconds)));
+    helper.Install(nodes.Get(i));
+
+    sync_metrics.Connect(nodes.Get(i)->GetApplication(0), nid);
+  }
+
+  Simulator::Stop(Seconds(TotalRunTimeSeconds));
+
+  std::string file_name = "results/WifiN" + std::to_string(N) + "A" +
+                          std::to_string(static_cast<int>(AreaSide));
+  if (MaxSpeed > 0.0) file_name += "S" + std::to_string(MaxSpeed);
+  if (Synchronized) file_name += "Sync";
+  if (DataRate != 1.0) file_name += "DR" + std::to_string(DataRate);
+  if (RngSeedManager::GetRun() != 1)
+    file_name += "Run" + std::to_string(RngSeedManager::GetRun());
+
+  ndn::vsync::TrafficCounter::InstallAll();
+
+  Simulator::Run();
+  Simulator::Destroy();
+
+  sync_metrics.ReportDataDelays(file_name, true, true);
+
+  uint64_t published = sync_metrics.GetPublishedCount();
+  if (published > 0)
+    std::cout << "Delivery ratio is: "
+              << static_cast<double>(sync_metrics.GetDeliveredCount()) /
+                     (published * (N - 1))
+              << std::endl;
+
+  using ndn::vsync::TrafficCounter;
+  double sync_airtime =
+      Airtime(TrafficCounter::GetPackets(TrafficCounter::kSyncInterest),
+              TrafficCounter::GetBytes(TrafficCounter::kSyncInterest),
+              kWifiRateMbps);
+  double data_airtime =
+      Airtime(TrafficCounter::GetPackets(TrafficCounter::kDataInterest) +
+                  TrafficCounter::GetPackets(TrafficCounter::kData),
+              TrafficCounter::GetBytes(TrafficCounter::kDataInterest) +
+                  TrafficCounter::GetBytes(TrafficCounter::kData),
+              kWifiRateMbps);
+  std::cout << "Sync airtime is: " << sync_airtime << " seconds." << std::endl;
+  std::cout << "Data airtime is: " << data_airtime << " seconds." << std::endl;
+  std::cout << "Channel utilization is: "
+            << (sync_airtime + data_airtime) / (TotalRunTimeSeconds - 1.0)
+            << std::endl;
+
+  return 0;
+}
+
+}  // namespace ns3
+
+int main(int argc, char* argv[]) { return ns3::main(argc, argv); }
@@ -0,0 +1,102 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+// Prints a binary event log written by EventLog as text, one event per line
+// in the format of the scenarios' NS_LOG_INFO output:
+//
+//   ./build/event-log-decode results/D10N20-events.bin
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "event-log-format.hpp"
+
+using namespace ndn::vsync::app;
+
+int main(int argc, char* argv[]) {
+  if (argc != 2) {
+    std::cerr << "Usage: " << argv[0] << " EVENT_LOG" << std::endl;
+    return -1;
+  }
+  std::FILE* file = std::fopen(argv[1], "rb");
+  if (file == nullptr) {
+    std::cerr << "Cannot open " << argv[1] << std::endl;
+    return -1;
+  }
+
+  char magic[sizeof(kEventLogMagic)];
+  if (std::fread(magic, 1, sizeof(magic), file) != sizeof(magic) ||
+      std::memcmp(magic, kEventLogMagic, sizeof(magic)) != 0) {
+    std::cerr << argv[1] << " is not an event log" << std::endl;
+    return -1;
+  }
+
+  std::vector<std::string> strings;
+  auto str = [&strings](uint64_t id) -> const std::string& {
+    static const std::string unknown = "?";
+    return id < strings.size() ? strings[id] : unknown;
+  };
+
+  EventRecord r;
+  std::vector<char> payload;
+  while (std::fread(&r, sizeof(r), 1, file) == 1) {
+    payload.resize(PaddedPayload(r.payload));
+    if (!payload.empty() &&
+        std::fread(payload.data(), 1, payload.size(), file) != payload.size()) {
+      std::cerr << "Truncated record at the end of the log" << std::endl;
+      break;
+    }
+
+    if (r.type == kString) {
+      if (r.a >= strings.size()) strings.resize(r.a + 1);
+      strings[r.a].assign(payload.data(), r.payload);
+      continue;
+    }
+
+    std::cout << r.time << "s ";
+    switch (r.type) {
+      case kViewChange: {
+        std::cout << "node_id=\"" << str(r.node)
+                  << "\", is_leader=" << (r.flags ? 'Y' : 'N')
+                  << ", view_id=(" << r.a << "," << str(r.b) << ")";
+        if (r.payload > 0) {
+          std::cout << ", view_info=[";
+          for (uint32_t i = 0; i < r.payload / sizeof(uint32_t); ++i) {
+            uint32_t id;
+            std::memcpy(&id, payload.data() + i * sizeof(id), sizeof(id));
+            std::cout << (i > 0 ? "," : "") << str(id);
+          }
+          std::cout << "]";
+        }
+        break;
+      }
+      case kDataEvent:
+        std::cout << "new_data_name=" << str(r.a) << ", node_id=" << str(r.node)
+                  << ", is_local=" << (r.flags ? "true" : "false");
+        break;
+      case kVectorChange: {
+        std::cout << "node_id=\"" << str(r.node) << "\", node_index=" << r.a
+                  << ", vector_clock=[";
+        for (uint32_t i = 0; i < r.payload / sizeof(uint64_t); ++i) {
+          uint64_t v;
+          std::memcpy(&v, payload.data() + i * sizeof(v), sizeof(v));
+          std::cout << (i > 0 ? "," : "") << v;
+        }
+        std::cout << "]";
+        break;
+      }
+      case kNodeStop:
+        std::cout << "node " << str(r.node) << " stops";
+        break;
+      default:
+        std::cout << "unknown event type " << r.type;
+    }
+    std::cout << '\n';
+  }
+
+  std::fclose(file);
+  return 0;
+}
@@ -0,0 +1,394 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+// Summarizes the result files of a directory of runs: the -sync-delay and
+// -prop-delay files of SyncMetrics and the scenarios, and the
+// -rate-trace.txt files of L3RateTracer.
+//
+// Files are parsed in parallel, each one mapped into memory. A run is a
+// file name without its suffix; a configuration is a run name without its
+// "Run<k>" part, so the seeds of one configuration are pooled. Writes, to
+// the output directory:
+//
+//   runs.txt       delay count, mean and percentiles of every run
+//   configs.txt    the same for every configuration, pooled over its runs
+//   cdf.txt        the delay CDF of every configuration, at most CdfPoints
+//                  points each
+//   overhead.txt   packets and kilobytes by trace type of every run
+//
+// All tables are tab-separated with a header line, for read.table().
+//
+//   ./build/postprocess --Threads=8 --Output=results/summary results
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+enum FileKind { kSyncDelay, kPropDelay, kRateTrace };
+
+const struct {
+  FileKind kind;
+  const char* suffix;
+  const char* metric;
+} kSuffixes[] = {
+    {kSyncDelay, "-sync-delay", "sync-delay"},
+    {kPropDelay, "-prop-delay", "prop-delay"},
+    {kRateTrace, "-rate-trace.txt", "rate-trace"},
+};
+
+struct ResultFile {
+  std::string path;
+  std::string run;
+  std::string config;
+  FileKind kind;
+  std::string metric;
+
+  // Filled in by the workers.
+  std::vector<double> delays;
+  // Packets and kilobytes by trace type, e.g. OutInterests.
+  std::map<std::string, std::pair<double, double>> overhead;
+  std::string error;
+};
+
+// Read-only mapping of a whole file.
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return;
+    struct stat st;
+    if (fstat(fd, &st) == 0) {
+      ok_ = true;
+      if (st.st_size > 0) {
+        void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+          ok_ = false;
+        } else {
+          data_ = static_cast<const char*>(p);
+          size_ = st.st_size;
+          madvise(p, size_, MADV_SEQUENTIAL);
+        }
+      }
+    }
+    close(fd);
+  }
+
+  ~MappedFile() {
+    if (data_ != nullptr) munmap(const_cast<char*>(data_), size_);
+  }
+
+  bool ok() const { return ok_; }
+  const char* begin() const { return data_; }
+  const char* end() const { return data_ + size_; }
+
+ private:
+  const char* data_ = nullptr;
+  std::size_t size_ = 0;
+  bool ok_ = false;
+};
+
+// Parses a decimal number (with optional sign, fraction and exponent) at
+// |p|, leaving |p| after it. Returns false if there is none.
+bool ParseNumber(const char*& p, const char* end, double& value) {
+  while (p < end && (*p == ' ' || *p == '\t')) ++p;
+  const char* start = p;
+  bool negative = false;
+  if (p < end && (*p == '-' || *p == '+')) negative = *p++ == '-';
+  double v = 0.0;
+  bool digits = false;
+  while (p < end && *p >= '0' && *p <= '9') {
+    v = v * 10 + (*p++ - '0');
+    digits = true;
+  }
+  if (p < end && *p == '.') {
+    ++p;
+    double scale = 0.1;
+    while (p < end && *p >= '0' && *p <= '9') {
+      v += (*p++ - '0') * scale;
+      scale *= 0.1;
+      digits = true;
+    }
+  }
+  if (!digits) {
+    p = start;
+    return false;
+  }
+  if (p < end && (*p == 'e' || *p == 'E')) {
+    const char* exp_start = p++;
+    bool exp_negative = false;
+    if (p < end && (*p == '-' || *p == '+')) exp_negative = *p++ == '-';
+    int exp = 0;
+    bool exp_digits = false;
+    while (p < end && *p >= '0' && *p <= '9') {
+      exp = exp * 10 + (*p++ - '0');
+      exp_digits = true;
+    }
+    if (exp_digits)
+      v *= std::pow(10.0, exp_negative ? -exp : exp);
+    else
+      p = exp_start;
+  }
+  value = negative ? -v : v;
+  return true;
+}
+
+const char* NextLine(const char* p, const char* end) {
+  const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+  return nl == nullptr ? end : nl + 1;
+}
+
+// "<gen_time>\t<time>" per line; the delay is their difference.
+void ParseDelays(const MappedFile& file, ResultFile& result) {
+  for (const char* p = file.begin(); p < file.end();) {
+    const char* next = NextLine(p, file.end());
+    double gen_time, time;
+    if (ParseNumber(p, next, gen_time) && ParseNumber(p, next, time))
+      result.delays.push_back(time - gen_time);
+    p = next;
+  }
+}
+
+// L3RateTracer: Time Node FaceId FaceDescr Type Packets Kilobytes
+// PacketRaw KilobytesRaw, tab-separated. The raw columns are the counts of
+// each period, so they add up over periods, faces and nodes.
+void ParseRateTrace(const MappedFile& file, ResultFile& result) {
+  const char* p = NextLine(file.begin(), file.end());  // Header.
+  while (p < file.end()) {
+    const char* next = NextLine(p, file.end());
+    const char* field[9];
+    int n = 0;
+    field[n++] = p;
+    for (const char* q = p; q < next && n < 9; ++q)
+      if (*q == '\t') field[n++] = q + 1;
+    double packets, kilobytes;
+    if (n == 9) {
+      const char* type_end = static_cast<const char*>(
+          std::memchr(field[4], '\t', next - field[4]));
+      const char* q = field[7];
+      const char* r = field[8];
+      if (type_end != nullptr && ParseNumber(q, next, packets) &&
+          ParseNumber(r, next, kilobytes)) {
+        auto& total = result.overhead[std::string(field[4], type_end)];
+        total.first += packets;
+        total.second += kilobytes;
+      }
+    }
+    p = next;
+  }
+}
+
+void Process(ResultFile& result) {
+  MappedFile file(result.path);
+  if (!file.ok()) {
+    result.error = std::strerror(errno);
+    return;
+  }
+  if (result.kind == kRateTrace)
+    ParseRateTrace(file, result);
+  else
+    ParseDelays(file, result);
+}
+
+// Strips the first "Run<digits>" from a run name.
+std::string ConfigOf(const std::string& run) {
+  for (std::size_t pos = run.find("Run"); pos != std::string::npos;
+       pos = run.find("Run", pos + 1)) {
+    std::size_t end = pos + 3;
+    while (end < run.size() && std::isdigit(run[end])) ++end;
+    if (end > pos + 3) return run.substr(0, pos) + run.substr(end);
+  }
+  return run;
+}
+
+void Scan(const std::string& dir, const std::string& rel,
+          std::vector<ResultFile>& files) {
+  DIR* d = opendir(dir.c_str());
+  if (d == nullptr) return;
+  while (struct dirent* entry = readdir(d)) {
+    std::string name = entry->d_name;
+    if (name == "." || name == "..") continue;
+    std::string path = dir + "/" + name;
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) continue;
+    if (S_ISDIR(st.st_mode)) {
+      Scan(path, rel + name + "/", files);
+      continue;
+    }
+    for (const auto& s : kSuffixes) {
+      std::size_t len = std::strlen(s.suffix);
+      if (name.size() <= len ||
+          name.compare(name.size() - len, len, s.suffix) != 0)
+        continue;
+      ResultFile f;
+      f.path = path;
+      f.run = rel + name.substr(0, name.size() - len);
+      f.config = ConfigOf(f.run);
+      f.kind = s.kind;
+      f.metric = s.metric;
+      files.push_back(std::move(f));
+      break;
+    }
+  }
+  closedir(d);
+}
+
+// Runs |fn(i)| for i in [0, n) on |threads| threads.
+template <typename Fn>
+void ParallelFor(std::size_t n, unsigned threads, Fn fn) {
+  std::atomic<std::size_t> next(0);
+  std::vector<std::thread> workers;
+  for (unsigned t = 0; t < threads; ++t)
+    workers.emplace_back([&] {
+      for (std::size_t i; (i = next++) < n;) fn(i);
+    });
+  for (auto& w : workers) w.join();
+}
+
+// Nearest-rank percentile of sorted |v|.
+double Percentile(const std::vector<double>& v, double q) {
+  std::size_t rank = static_cast<std::size_t>(std::ceil(q * v.size()));
+  return v[rank == 0 ? 0 : rank - 1];
+}
+
+const char* kSummaryHeader =
+    "Metric\tCount\tMean\tP50\tP90\tP95\tP99\tMax";
+
+void WriteSummary(std::ostream& os, const std::string& metric,
+                  const std::vector<double>& sorted) {
+  double sum = 0.0;
+  for (double d : sorted) sum += d;
+  os << metric << '\t' << sorted.size() << '\t' << sum / sorted.size()
+     << '\t' << Percentile(sorted, 0.5) << '\t' << Percentile(sorted, 0.9)
+     << '\t' << Percentile(sorted, 0.95) << '\t' << Percentile(sorted, 0.99)
+     << '\t' << sorted.back() << '\n';
+}
+
+struct Pool {
+  std::string config;
+  std::string metric;
+  int runs = 0;
+  std::vector<double> delays;
+};
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+  std::string output;
+  std::size_t cdf_points = 200;
+  std::string dir = "results";
+
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg.compare(0, 10, "--Threads=") == 0) {
+      threads = std::max(1, std::atoi(arg.c_str() + 10));
+    } else if (arg.compare(0, 9, "--Output=") == 0) {
+      output = arg.substr(9);
+    } else if (arg.compare(0, 12, "--CdfPoints=") == 0) {
+      cdf_points = std::max(2, std::atoi(arg.c_str() + 12));
+    } else if (arg.compare(0, 2, "--") == 0) {
+      std::cerr << "Usage: " << argv[0]
+                << " [--Threads=N] [--Output=DIR] [--CdfPoints=N] [DIR]"
+                << std::endl;
+      return arg == "--help" ? 0 : -1;
+    } else {
+      dir = arg;
+    }
+  }
+  if (output.empty()) output = dir + "/summary";
+
+  std::vector<ResultFile> files;
+  Scan(dir, "", files);
+  // Keep our own output out of the next scan's way.
+  files.erase(std::remove_if(files.begin(), files.end(),
+                             [&](const ResultFile& f) {
+                               return f.path.compare(0, output.size(),
+                                                     output) == 0;
+                             }),
+              files.end());
+  std::sort(files.begin(), files.end(),
+            [](const ResultFile& a, const ResultFile& b) {
+              return a.path < b.path;
+            });
+  if (files.empty()) {
+    std::cerr << "No result files in " << dir << std::endl;
+    return -1;
+  }
+
+  ParallelFor(files.size(), threads, [&](std::size_t i) {
+    Process(files[i]);
+    std::sort(files[i].delays.begin(), files[i].delays.end());
+  });
+
+  mkdir(output.c_str(), 0755);
+  std::ofstream runs(output + "/runs.txt");
+  std::ofstream overhead(output + "/overhead.txt");
+  runs << "Run\tConfig\t" << kSummaryHeader << '\n';
+  overhead << "Run\tConfig\tType\tPackets\tKilobytes\n";
+
+  std::map<std::pair<std::string, std::string>, Pool> pools;
+  for (const auto& f : files) {
+    if (!f.error.empty()) {
+      std::cerr << f.path << ": " << f.error << std::endl;
+      continue;
+    }
+    for (const auto& o : f.overhead)
+      overhead << f.run << '\t' << f.config << '\t' << o.first << '\t'
+               << o.second.first << '\t' << o.second.second << '\n';
+    if (f.delays.empty()) continue;
+    runs << f.run << '\t' << f.config << '\t';
+    WriteSummary(runs, f.metric, f.delays);
+    Pool& pool = pools[std::make_pair(f.config, f.metric)];
+    pool.config = f.config;
+    pool.metric = f.metric;
+    ++pool.runs;
+    pool.delays.insert(pool.delays.end(), f.delays.begin(), f.delays.end());
+  }
+
+  std::vector<Pool*> pool_list;
+  for (auto& p : pools) pool_list.push_back(&p.second);
+  ParallelFor(pool_list.size(), threads, [&](std::size_t i) {
+    std::sort(pool_list[i]->delays.begin(), pool_list[i]->delays.end());
+  });
+
+  std::ofstream configs(output + "/configs.txt");
+  std::ofstream cdf(output + "/cdf.txt");
+  configs << "Config\tRuns\t" << kSummaryHeader << '\n';
+  cdf << "Config\tMetric\tDelay\tCDF\n";
+  for (const Pool* pool : pool_list) {
+    configs << pool->config << '\t' << pool->runs << '\t';
+    WriteSummary(configs, pool->metric, pool->delays);
+
+    // Evenly spaced ranks, always including the minimum and the maximum.
+    const auto& v = pool->delays;
+    std::size_t points = std::min(cdf_points, v.size());
+    for (std::size_t k = 0; k < points; ++k) {
+      std::size_t rank =
+          points == 1 ? v.size() - 1 : k * (v.size() - 1) / (points - 1);
+      cdf << pool->config << '\t' << pool->metric << '\t' << v[rank] << '\t'
+          << static_cast<double>(rank + 1) / v.size() << '\n';
+    }
+  }
+
+  std::cout << "Processed " << files.size() << " files of " << pools.size()
+            << " configurations into " << output << std::endl;
+  return 0;
+}
@@ -0,0 +1,284 @@
+#!/usr/bin/env python
+# -*- Mode: python; py-indent-offset: 4; indent-tabs-mode: nil; coding: utf-8; -*-
+
+# Tunes the heartbeat interval, interest lifetime and CS size of a sync group
+# by successive halving over the engine scenario.
+#
+# Every candidate setting is first run with one seed (ns-3 RngRun). The
+# best 1/eta of the candidates are rerun with eta times as many seeds, and
+# so on, until the survivors have been run with --max-seeds seeds. A
+# candidate is feasible when its p99 sync delay meets --p99 and its
+# completion rate (data fully synchronized / data published) meets
+# --completion; feasible candidates are ranked by sync interest bytes per
+# delivered data, infeasible ones by how far they miss the constraints.
+#
+# The engine ignores LifetimeMultiple and HBMultiple when a config sets
+# absolute lifetimes or a heartbeat interval, so for such configs the
+# multiples are turned into absolute overrides of those keys: lifetimes of
+# LifetimeMultiple * LinkDelayMS and a heartbeat of HBMultiple data
+# intervals.
+#
+# Example:
+#
+#     ./tune.py --config configs/hub-and-spoke.conf --nodes 20 \
+#               --data-rate 2 --loss-rate 0.01 --p99 0.5
+
+from __future__ import print_function
+
+import argparse
+import itertools
+import math
+import multiprocessing
+import os
+import re
+import subprocess
+
+parser = argparse.ArgumentParser(description='Heartbeat and interest lifetime tuner')
+parser.add_argument('--config', default='configs/hub-and-spoke.conf',
+                    help='engine scenario description (topology and workload)')
+parser.add_argument('--nodes', type=int, help='NumOfNodes override')
+parser.add_argument('--data-rate', type=float, help='DataRate override')
+parser.add_argument('--loss-rate', type=float, help='LossRate override')
+parser.add_argument('--run-time', type=float, default=60.0,
+                    help='TotalRunTimeSeconds of every simulation')
+
+parser.add_argument('--p99', type=float, default=1.0,
+                    help='p99 sync delay target in seconds')
+parser.add_argument('--completion', type=float, default=0.99,
+                    help='minimum fraction of data fully synchronized')
+
+parser.add_argument('--hb', default='1,2,4,8',
+                    help='HBMultiple candidates')
+parser.add_argument('--lifetime', default='2,3,5,10,20',
+                    help='LifetimeMultiple candidates')
+parser.add_argument('--cs', default='100,1000,10000',
+                    help='CsSize candidates')
+
+parser.add_argument('--eta', type=int, default=3,
+                    help='keep 1/eta of the candidates at each round')
+parser.add_argument('--max-seeds', type=int, default=9,
+                    help='seeds per candidate in the last round')
+parser.add_argument('-j', '--jobs', type=int, default=multiprocessing.cpu_count(),
+                    help='simulations run in parallel')
+parser.add_argument('--binary', default='./build/engine')
+parser.add_argument('--output', default='results/tune',
+                    help='directory for simulation outputs and the Pareto front')
+
+args = parser.parse_args()
+
+PARAMETERS = ['HBMultiple', 'LifetimeMultiple', 'CsSize']
+
+# Absolute keys of the engine that take precedence over a multiple.
+ABSOLUTE_KEYS = {
+    'LifetimeMultiple': ['SyncInterestLifetimeMS', 'DataInterestLifetimeMS'],
+    'HBMultiple': ['HeartbeatIntervalMS'],
+}
+
+######################################################################
+
+def read_config(path):
+    "Key = value pairs of an engine config, as ScenarioConfig reads them"
+    config = {}
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if not line or line.startswith('#') or '=' not in line:
+                continue
+            key, value = line.split('=', 1)
+            config[key.strip()] = value.strip()
+    return config
+
+config = read_config(args.config)
+
+def absolute_overrides(name, value):
+    "Overrides of the absolute keys the config sets in place of multiple |name|"
+    keys = [k for k in ABSOLUTE_KEYS[name] if k in config]
+    if name == 'LifetimeMultiple':
+        unit = int(config.get('LinkDelayMS', 10))
+    else:
+        data_rate = args.data_rate if args.data_rate is not None else float(config.get('DataRate', 1.0))
+        unit = int(1000.0 / data_rate)
+    return ['%s=%d' % (k, int(value) * unit) for k in keys]
+
+def overrides(setting):
+    sets = ['%s=%s' % (k, v) for k, v in zip(PARAMETERS, setting)]
+    for name, value in zip(PARAMETERS, setting):
+        if name in ABSOLUTE_KEYS:
+            sets += absolute_overrides(name, value)
+    sets.append('TotalRunTimeSeconds=%s' % args.run_time)
+    sets.append('Metrics=sync-delay,traffic')
+    if args.nodes is not None:
+        sets.append('NumOfNodes=%d' % args.nodes)
+    if args.data_rate is not None:
+        sets.append('DataRate=%s' % args.data_rate)
+    if args.loss_rate is not None:
+        sets.append('LossRate=%s' % args.loss_rate)
+    return ';'.join(sets)
+
+def set_string(setting):
+    return overrides(setting) + ';Output=' + args.output + '/run'
+
+def output_prefix(setting, seed):
+    # Mirrors how engine names its outputs: Output, the sanitized overrides
+    # and the run number.
+    prefix = args.output + '/run-' + re.sub(r'[^A-Za-z0-9.]', '_', set_string(setting))
+    if seed != 1:
+        prefix += 'Run%d' % seed
+    return prefix
+
+def simulate(job):
+    "Runs one setting with one seed and returns its raw measurements"
+    setting, seed = job
+    prefix = output_prefix(setting, seed)
+    cmdline = [args.binary, '--Config=' + args.config,
+               '--Set=' + set_string(setting), '--RngRun=%d' % seed]
+    try:
+        stdout = subprocess.check_output(cmdline, stderr=subprocess.STDOUT)
+    except subprocess.CalledProcessError as e:
+        print('FAILED: ' + ' '.join(cmdline))
+        print(e.output)
+        return None
+
+    summary = {}
+    for line in stdout.decode().splitlines():
+        if ' is: ' in line:
+            key, value = line.split(' is: ', 1)
+            summary[key] = float(value.split()[0])
+
+    delays = []
+    with open(prefix + '-sync-delay') as f:
+        for line in f:
+            gen_time, max_time = line.split()[:2]
+            delays.append(float(max_time) - float(gen_time))
+
+    return {
+        'published': summary.get('Total number of data published', 0),
+        'synchronized': summary.get('Total number of data fully synchronized', 0),
+        'sync_bytes': summary.get('Sync interest bytes per delivered data', float('inf')),
+        'delays': delays,
+    }
+
+def percentile(values, p):
+    if not values:
+        return float('inf')
+    values = sorted(values)
+    return values[min(len(values) - 1, int(math.ceil(p * len(values))) - 1)]
+
+class Candidate:
+    def __init__(self, setting):
+        self.setting = setting
+        self.runs = []
+
+    def seeds(self):
+        return len(self.runs)
+
+    def summarize(self):
+        runs = [r for r in self.runs if r is not None]
+        published = sum(r['published'] for r in runs)
+        self.completion = sum(r['synchronized'] for r in runs) / published if published else 0.0
+        self.p99 = percentile([d for r in runs for d in r['delays']], 0.99)
+        self.sync_bytes = (sum(r['sync_bytes'] for r in runs) / len(runs)
+                           if runs else float('inf'))
+        self.feasible = self.p99 <= args.p99 and self.completion >= args.completion
+
+    def rank(self):
+        if self.feasible:
+            return (0, self.sync_bytes)
+        violation = (max(0.0, self.p99 / args.p99 - 1.0) +
+                     max(0.0, args.completion - self.completion) / args.completion)
+        return (1, violation)
+
+    def describe(self):
+        return ' '.join('%s=%s' % (k, v) for k, v in zip(PARAMETERS, self.setting))
+
+def successive_halving(candidates, pool):
+    seeds = 1
+    alive = list(candidates)
+    while True:
+        jobs = [(c, s) for c in alive for s in range(c.seeds() + 1, seeds + 1)]
+        print('Round with %d seeds: %d candidates, %d simulations' % (seeds, len(alive), len(jobs)))
+        results = pool.map(simulate, [(c.setting, s) for c, s in jobs])
+        for (c, s), r in zip(jobs, results):
+            c.runs.append(r)
+        for c in alive:
+            c.summarize()
+        alive.sort(key=Candidate.rank)
+        if seeds >= args.max_seeds or len(alive) == 1:
+            return alive
+        alive = alive[:max(1, len(alive) // args.eta)]
+        seeds = min(args.max_seeds, seeds * args.eta)
+
+def warn_no_effect(candidates):
+    "Warns about parameters whose candidates gave identical first-seed runs"
+    for i, name in enumerate(PARAMETERS):
+        groups = {}
+        for c in candidates:
+            if c.runs and c.runs[0] is not None:
+                r = c.runs[0]
+                rest = c.setting[:i] + c.setting[i + 1:]
+                groups.setdefault(rest, []).append((r['sync_bytes'], tuple(r['delays'])))
+        compared = [g for g in groups.values() if len(g) > 1]
+        if compared and all(len(set(g)) == 1 for g in compared):
+            print('WARNING: %s had no effect on any run; check that %s uses it' % (
+                name, args.config))
+
+def pareto_front(candidates):
+    "Candidates not dominated in (sync bytes, p99 delay, -completion)"
+    front = []
+    for c in candidates:
+        dominated = False
+        for o in candidates:
+            if o is c:
+                continue
+            if (o.sync_bytes <= c.sync_bytes and o.p99 <= c.p99 and
+                    o.completion >= c.completion and
+                    (o.sync_bytes, o.p99, -o.completion) != (c.sync_bytes, c.p99, -c.completion)):
+                dominated = True
+                break
+        if not dominated:
+            front.append(c)
+    return sorted(front, key=lambda c: c.sync_bytes)
+
+######################################################################
+
+if __name__ == '__main__':
+    if not os.path.exists(args.output):
+        os.makedirs(args.output)
+
+    for name in ABSOLUTE_KEYS:
+        keys = [k for k in ABSOLUTE_KEYS[name] if k in config]
+        if keys:
+            print('WARNING: %s sets %s, which the engine uses instead of %s; '
+                  'the tuner overrides %s from the %s candidates' % (
+                      args.config, ', '.join(keys), name, ', '.join(keys), name))
+
+    grid = itertools.product(*[s.split(',') for s in (args.hb, args.lifetime, args.cs)])
+    candidates = [Candidate(setting) for setting in grid]
+
+    pool = multiprocessing.Pool(args.jobs)
+    try:
+        survivors = successive_halving(candidates, pool)
+    finally:
+        pool.close()
+        pool.join()
+    warn_no_effect(candidates)
+
+    front = pareto_front(candidates)
+    with open(args.output + '/pareto.txt', 'w') as f:
+        f.write('\t'.join(PARAMETERS) + '\tSeeds\tSyncBytesPerData\tP99Delay\tCompletion\tFeasible\n')
+        for c in front:
+            f.write('\t'.join(c.setting) + '\t%d\t%f\t%f\t%f\t%s\n' % (
+                c.seeds(), c.sync_bytes, c.p99, c.completion, 'Y' if c.feasible else 'N'))
+
+    print('Pareto front (sync bytes per data, p99 delay, completion):')
+    for c in front:
+        print('    %s: %.1f bytes, %.3f s, %.4f (%d seeds)' % (
+            c.describe(), c.sync_bytes, c.p99, c.completion, c.seeds()))
+
+    best = survivors[0]
+    if best.feasible:
+        print('Recommended setting: %s (%.1f sync bytes per data, p99 %.3f s, completion %.4f)' % (
+            best.describe(), best.sync_bytes, best.p99, best.completion))
+    else:
+        print('No setting meets p99 <= %s s and completion >= %s; closest is %s' % (
+            args.p99, args.completion, best.describe()))